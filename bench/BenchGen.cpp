@@ -0,0 +1,547 @@
+#include "BenchGen.h"
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+namespace BenchGen
+{
+
+// splitmix64 of (seed, a, b)
+inline uint64_t hash3(uint64_t seed, uint64_t a, uint64_t b)
+{
+  uint64_t z = seed * 0x9E3779B97F4A7C15ull ^ (a + 0x632BE59BD9B4E019ull) * 0xBF58476D1CE4E5B9ull ^ b;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+
+void
+Generator::makeLibrary()
+{
+  // INV, NAND2, NAND3, NAND4, DFF in several drive strengths
+  static const char* baseName[] = {"INV", "NAND2", "NAND3", "NAND4", "DFF"};
+
+  for(int i = 0; i < opt_.numLib; i++)
+  {
+    int type     = i % 5;
+    int strength = 1 << (i / 5 % 4);
+
+    Master m;
+    m.name      = std::string(baseName[type]) + "_X" + std::to_string(strength) + "_" + std::to_string(i);
+    m.isSeq     = (type == 4);
+    m.numInput  = m.isSeq ? 1 : (type == 0 ? 1 : type + 1);
+    m.widthSite = (m.isSeq ? 6 : m.numInput + 1) + strength / 2;
+
+    masters_.push_back(m);
+  }
+
+  // Small cells are more common (weight 8 : 4 : 2 : 1 by strength)
+  std::vector<int> weights;
+  for(int i = 0; i < opt_.numLib; i++)
+    weights.push_back(8 >> (i / 5 % 4));
+
+  std::vector<int> table;
+  for(int i = 0; i < opt_.numLib; i++)
+    table.insert(table.end(), weights[i], i);
+
+  instMaster_.resize(opt_.numInst);
+
+  for(int64_t i = 0; i < opt_.numInst; i++)
+    instMaster_[i] = table[ hash3(opt_.seed, i, 0) % table.size() ];
+
+  siteW_  = static_cast<int64_t>(SITE_W * DB_UNIT);
+  siteH_  = static_cast<int64_t>(SITE_H * DB_UNIT);
+
+  // Block macros are 40 x 20 rows
+  blockW_ = 40 * siteH_;
+  blockH_ = 20 * siteH_;
+
+  // Die : square of (cell area / util) + blocks
+  double cellArea = 0.0;
+  for(int64_t i = 0; i < opt_.numInst; i++)
+    cellArea += double(masters_[instMaster_[i]].widthSite) * siteW_ * siteH_;
+
+  double dieArea  = cellArea / opt_.util + double(opt_.numBlock) * blockW_ * blockH_ * 1.2;
+  double dieSide  = std::sqrt(dieArea);
+
+  numRow_  = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(dieSide / siteH_)));
+  numSite_ = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(dieSide / siteW_)));
+
+  // Blocks need enough room
+  numRow_  = std::max<int64_t>(numRow_,  blockH_ / siteH_ + 1);
+  numSite_ = std::max<int64_t>(numSite_, blockW_ / siteW_ + 1);
+}
+
+int64_t
+Generator::inputNet(int64_t inst, int pin) const
+{
+  uint64_t h = hash3(opt_.seed, inst, pin + 1);
+
+  if(inst % TIE_PERIOD == 7 && pin == 0)
+    return (h & 1) ? TIE1 : TIE0;
+
+  if(inst == 0 || h % (NUM_IO_BIT * 64) == 0)
+    return opt_.numInst + (h >> 32) % NUM_IO_BIT;
+
+  if(h % GLOBAL_NET_RATIO == 1)
+    return (h >> 16) % inst;
+
+  int64_t window = std::min<int64_t>(inst, LOCAL_WINDOW);
+  return inst - 1 - static_cast<int64_t>((h >> 16) % window);
+}
+
+int64_t
+Generator::blockNet(int block, int bit) const
+{
+  uint64_t h = hash3(opt_.seed, block, 1000 + bit);
+  return opt_.numInst > 0 ? static_cast<int64_t>(h % opt_.numInst)
+                          : opt_.numInst + bit % NUM_IO_BIT;
+}
+
+// n<i> / b<k>[j] (bus chunk) / a<k> (alias) / din[b] / clk / 1'b0 / 1'b1
+void
+Generator::netName(Writer& w, int64_t net, bool useAlias) const
+{
+  if(net == TIE0)
+    w << "1'b0";
+  else if(net == TIE1)
+    w << "1'b1";
+  else if(net == clkNet())
+    w << "clk";
+  else if(net >= opt_.numInst)
+    w << "din[" << (net - opt_.numInst) << "]";
+  else if(useAlias && net % ALIAS_PERIOD == ALIAS_PERIOD / 2)
+    w << "a" << (net / ALIAS_PERIOD);
+  else if((net / BUS_CHUNK) % 2 == 1)
+    w << "b" << (net / BUS_CHUNK) << "[" << (net % BUS_CHUNK) << "]";
+  else
+    w << "n" << net;
+}
+
+void
+Generator::writeLef(const std::filesystem::path& path) const
+{
+  Writer w(path);
+
+  w << "VERSION 5.8 ;\n";
+  w << "BUSBITCHARS \"[]\" ;\n";
+  w << "DIVIDERCHAR \"/\" ;\n";
+  w << "UNITS\n  DATABASE MICRONS " << DB_UNIT << " ;\nEND UNITS\n";
+  w << "SITE core\n  CLASS CORE ;\n  SIZE ";
+  w.micron(siteW_) << " BY ";
+  w.micron(siteH_) << " ;\nEND core\n";
+
+  auto writePin = [&] (const std::string& pinName, const char* dir,
+                       int64_t lx, int64_t ly, int64_t ux, int64_t uy)
+  {
+    w << "  PIN " << pinName << "\n";
+    w << "    DIRECTION " << dir << " ;\n    USE SIGNAL ;\n";
+    w << "    PORT\n      LAYER M1 ;\n      RECT ";
+    w.micron(lx) << " ";
+    w.micron(ly) << " ";
+    w.micron(ux) << " ";
+    w.micron(uy) << " ;\n    END\n";
+    w << "  END " << pinName << "\n";
+  };
+
+  static const char* inputName[] = {"A", "B", "C", "D"};
+
+  for(const Master& m : masters_)
+  {
+    w << "MACRO " << m.name << "\n";
+    w << "  CLASS CORE ;\n  ORIGIN 0 0 ;\n  SIZE ";
+    w.micron(m.widthSite * siteW_) << " BY ";
+    w.micron(siteH_) << " ;\n  SITE core ;\n";
+
+    int64_t pitch = siteW_;
+    int64_t y0    = siteH_ / 4;
+    int64_t y1    = siteH_ * 3 / 4;
+
+    if(m.isSeq)
+    {
+      writePin("D",  "INPUT",  pitch / 4,             y0, pitch * 3 / 4,             y1);
+      writePin("CK", "INPUT",  pitch + pitch / 4,     y0, pitch + pitch * 3 / 4,     y1);
+      writePin("Q",  "OUTPUT", 4 * pitch + pitch / 4, y0, 4 * pitch + pitch * 3 / 4, y1);
+    }
+    else
+    {
+      for(int p = 0; p < m.numInput; p++)
+        writePin(inputName[p], "INPUT", p * pitch + pitch / 4, y0, p * pitch + pitch * 3 / 4, y1);
+
+      int64_t x = m.numInput * pitch;
+      writePin("Y", "OUTPUT", x + pitch / 4, y0, x + pitch * 3 / 4, y1);
+    }
+
+    w << "END " << m.name << "\n";
+  }
+
+  // Block macro (no SITE)
+  w << "MACRO BLOCK\n  CLASS BLOCK ;\n  ORIGIN 0 0 ;\n  SIZE ";
+  w.micron(blockW_) << " BY ";
+  w.micron(blockH_) << " ;\n";
+
+  for(int bit = 0; bit < BLOCK_PIN_BIT; bit++)
+  {
+    int64_t y = (bit + 1) * blockH_ / (BLOCK_PIN_BIT + 1);
+    writePin("A[" + std::to_string(bit) + "]", "INPUT",  0, y, siteW_, y + siteW_);
+    writePin("Y[" + std::to_string(bit) + "]", "OUTPUT", blockW_ - siteW_, y, blockW_, y + siteW_);
+  }
+
+  w << "END BLOCK\n";
+  w << "END LIBRARY\n";
+}
+
+void
+Generator::writeVerilog(const std::filesystem::path& path) const
+{
+  Writer w(path);
+
+  const int64_t numInst = opt_.numInst;
+
+  w << "// Generated by Parser_gen (seed " << static_cast<int64_t>(opt_.seed) << ")\n";
+  w << "module " << opt_.name << " ( clk, din, dout );\n";
+  w << "  input clk;\n";
+  w << "  input [" << NUM_IO_BIT - 1 << ":0] din;\n";
+  w << "  output [" << NUM_IO_BIT - 1 << ":0] dout;\n";
+
+  // Output nets of instances (scalar wires and buses)
+  for(int64_t i = 0; i < numInst; i += BUS_CHUNK)
+  {
+    if((i / BUS_CHUNK) % 2 == 1)
+    {
+      int64_t width = std::min<int64_t>(BUS_CHUNK, numInst - i);
+      w << "  wire [" << width - 1 << ":0] b" << (i / BUS_CHUNK) << ";\n";
+    }
+    else
+    {
+      for(int64_t j = i; j < std::min<int64_t>(i + BUS_CHUNK, numInst); j++)
+        w << "  wire n" << j << ";\n";
+    }
+  }
+
+  // Block outputs are not loaded (only to have bus pins)
+  for(int k = 0; k < opt_.numBlock; k++)
+    w << "  wire [" << BLOCK_PIN_BIT - 1 << ":0] blk" << k << "_y;\n";
+
+  // Alias wires
+  for(int64_t i = ALIAS_PERIOD / 2; i < numInst; i += ALIAS_PERIOD)
+    w << "  wire a" << (i / ALIAS_PERIOD) << ";\n";
+
+  // Unconnected buses (declaration-heavy netlist)
+  for(int64_t k = 0; k < opt_.numBusWire; k++)
+  {
+    int64_t msb = 1 + static_cast<int64_t>( hash3(opt_.seed, k, 300) % 8 );
+    w << "  wire [" << msb << ":0] bw" << k << ";\n";
+  }
+
+  for(int64_t i = ALIAS_PERIOD / 2; i < numInst; i += ALIAS_PERIOD)
+  {
+    w << "  assign a" << (i / ALIAS_PERIOD) << " = ";
+    netName(w, i, false);
+    w << ";\n";
+  }
+
+  for(int b = 0; b < NUM_IO_BIT; b++)
+  {
+    w << "  assign dout[" << b << "] = ";
+    netName(w, numInst > b ? numInst - 1 - b : numInst + b, false);
+    w << ";\n";
+  }
+
+  static const char* inputName[] = {"A", "B", "C", "D"};
+
+  for(int64_t i = 0; i < numInst; i++)
+  {
+    const Master& m = masters_[instMaster_[i]];
+
+    w << "  " << m.name << " u" << i << " ( ";
+
+    if(m.isSeq)
+    {
+      w << ".D(";
+      netName(w, inputNet(i, 0), true);
+      w << "), .CK(clk), .Q(";
+    }
+    else
+    {
+      for(int p = 0; p < m.numInput; p++)
+      {
+        w << "." << inputName[p] << "(";
+        netName(w, inputNet(i, p), true);
+        w << "), ";
+      }
+      w << ".Y(";
+    }
+
+    netName(w, i, false);
+    w << ") );\n";
+  }
+
+  for(int k = 0; k < opt_.numBlock; k++)
+  {
+    w << "  BLOCK blk" << k << " ( .A({";
+
+    for(int bit = BLOCK_PIN_BIT - 1; bit >= 0; bit--)
+    {
+      netName(w, blockNet(k, bit), true);
+      w << (bit > 0 ? ", " : "");
+    }
+
+    w << "}), .Y(blk" << k << "_y) );\n";
+  }
+
+  w << "endmodule\n";
+}
+
+void
+Generator::writeNets(Writer& w) const
+{
+  const int64_t numInst = opt_.numInst;
+  const int64_t nets    = numNet();
+
+  // Sinks of each driver net (CSR)
+  // Sink : instance * 8 + pin (pin 7 : CK)
+  std::vector<int64_t> start(nets + 1, 0);
+
+  auto forEachSink = [&] (auto&& visit)
+  {
+    for(int64_t i = 0; i < numInst; i++)
+    {
+      const Master& m = masters_[instMaster_[i]];
+
+      for(int p = 0; p < m.numInput; p++)
+        visit(inputNet(i, p), i * 8 + p);
+
+      if(m.isSeq)
+        visit(clkNet(), i * 8 + 7);
+    }
+  };
+
+  forEachSink([&] (int64_t net, int64_t) { if(net >= 0) start[net + 1]++; });
+
+  for(int64_t n = 0; n < nets; n++)
+    start[n + 1] += start[n];
+
+  std::vector<int64_t> sinks(start[nets]);
+  std::vector<int64_t> fill(start.begin(), start.end() - 1);
+
+  forEachSink([&] (int64_t net, int64_t sink) { if(net >= 0) sinks[fill[net]++] = sink; });
+
+  static const char* inputName[] = {"A", "B", "C", "D"};
+
+  w << "NETS " << nets << " ;\n";
+
+  for(int64_t n = 0; n < nets; n++)
+  {
+    w << "- ";
+    netName(w, n, false);
+
+    if(n < numInst)
+      w << " ( u" << n << (masters_[instMaster_[n]].isSeq ? " Q )" : " Y )");
+    else
+      w << " ( PIN " << (n == clkNet() ? "clk" : "din[" + std::to_string(n - numInst) + "]") << " )";
+
+    if(n < numInst && numInst - 1 - n < NUM_IO_BIT)
+      w << " ( PIN dout[" << (numInst - 1 - n) << "] )";
+
+    for(int64_t s = start[n]; s < start[n + 1]; s++)
+    {
+      int64_t inst = sinks[s] / 8;
+      int     pin  = sinks[s] % 8;
+
+      const Master& m = masters_[instMaster_[inst]];
+
+      w << " ( u" << inst << " " << (pin == 7 ? "CK" : (m.isSeq ? "D" : inputName[pin])) << " )";
+    }
+
+    w << " ;\n";
+  }
+
+  w << "END NETS\n";
+}
+
+void
+Generator::writeDef(const std::filesystem::path& path) const
+{
+  Writer w(path);
+
+  const int64_t numInst = opt_.numInst;
+  const int64_t dieW    = numSite_ * siteW_;
+  const int64_t dieH    = numRow_  * siteH_;
+
+  w << "VERSION 5.8 ;\n";
+  w << "DIVIDERCHAR \"/\" ;\n";
+  w << "BUSBITCHARS \"[]\" ;\n";
+  w << "DESIGN " << opt_.name << " ;\n";
+  w << "UNITS DISTANCE MICRONS " << DB_UNIT << " ;\n";
+  w << "DIEAREA ( 0 0 ) ( " << dieW << " " << dieH << " ) ;\n";
+
+  for(int64_t r = 0; r < numRow_; r++)
+  {
+    w << "ROW CORE_ROW_" << r << " core 0 " << r * siteH_ << (r % 2 == 0 ? " N" : " FS");
+    w << " DO " << numSite_ << " BY 1 STEP " << siteW_ << " 0 ;\n";
+  }
+
+  // Blocks along the bottom-left diagonal (in whole rows / sites)
+  const int64_t blockRows  = blockH_ / siteH_;
+  const int64_t blockSites = blockW_ / siteW_;
+
+  std::vector<int64_t> blockRow(opt_.numBlock);
+  std::vector<int64_t> blockSite(opt_.numBlock);
+
+  for(int k = 0; k < opt_.numBlock; k++)
+  {
+    blockRow[k]  = (k * blockRows * 3 / 2) % std::max<int64_t>(1, numRow_  - blockRows);
+    blockSite[k] = (k * blockSites * 3 / 2) % std::max<int64_t>(1, numSite_ - blockSites);
+  }
+
+  w << "COMPONENTS " << numInst + opt_.numBlock + opt_.numDummy << " ;\n";
+
+  for(int k = 0; k < opt_.numBlock; k++)
+  {
+    w << "- blk" << k << " BLOCK + FIXED ( " << blockSite[k] * siteW_ << " ";
+    w << blockRow[k] * siteH_ << " ) N ;\n";
+  }
+
+  // Standard cells fill the rows in the netlist order (short local nets)
+  // with random gaps, skipping the blocks
+  int64_t usedSites = 0;
+  for(int64_t i = 0; i < numInst; i++)
+    usedSites += masters_[instMaster_[i]].widthSite;
+
+  int64_t freeSites = numRow_ * numSite_ - int64_t(opt_.numBlock) * blockRows * blockSites;
+  double  avgGap    = numInst > 0 ? std::max(0.0, double(freeSites - usedSites) / numInst) : 0.0;
+
+  int64_t row  = 0;
+  int64_t site = 0;
+
+  auto blockAt = [&] (int64_t r, int64_t s, int64_t width)      // First site after the overlapping block (or -1)
+  {
+    for(int k = 0; k < opt_.numBlock; k++)
+    {
+      if(r >= blockRow[k] && r < blockRow[k] + blockRows
+      && s < blockSite[k] + blockSites && s + width > blockSite[k])
+        return blockSite[k] + blockSites;
+    }
+    return int64_t(-1);
+  };
+
+  for(int64_t i = 0; i < numInst; i++)
+  {
+    int64_t width = masters_[instMaster_[i]].widthSite;
+
+    uint64_t h = hash3(opt_.seed, i, 100);
+
+    // Gap in [0, 2 * avgGap]
+    site += static_cast<int64_t>( (h % 1024) / 1023.0 * 2.0 * avgGap + 0.5 );
+
+    while(true)
+    {
+      if(site + width > numSite_)
+      {
+        row++;
+        site = 0;
+      }
+
+      // Out of rows : the rest overlaps (still a valid DEF)
+      if(row >= numRow_)
+      {
+        row  = (h >> 20) % numRow_;
+        site = (h >> 40) % std::max<int64_t>(1, numSite_ - width);
+        break;
+      }
+
+      int64_t next = blockAt(row, site, width);
+
+      if(next < 0)
+        break;
+
+      site = next;
+    }
+
+    w << "- u" << i << " " << masters_[instMaster_[i]].name << " + PLACED ( ";
+    w << site * siteW_ << " " << row * siteH_ << " ) " << (row % 2 == 0 ? "N" : "FS") << " ;\n";
+
+    site += width;
+  }
+
+  // Dummy cells at random sites (they may overlap)
+  for(int64_t k = 0; k < opt_.numDummy; k++)
+  {
+    uint64_t h = hash3(opt_.seed, k, 200);
+
+    const Master& master = masters_[h % masters_.size()];
+
+    int64_t r = (h >> 8) % numRow_;
+    int64_t s = (h >> 32) % std::max<int64_t>(1, numSite_ - master.widthSite);
+
+    w << "- dummy" << k << " " << master.name << " + PLACED ( ";
+    w << s * siteW_ << " " << r * siteH_ << " ) " << (r % 2 == 0 ? "N" : "FS") << " ;\n";
+  }
+
+  w << "END COMPONENTS\n";
+
+  // IO pins on the left (din, clk) and right (dout) edges
+  w << "PINS " << 2 * NUM_IO_BIT + 1 << " ;\n";
+
+  auto writeIO = [&] (const std::string& pinName, const char* dir, int64_t x, int64_t y)
+  {
+    w << "- " << pinName << " + NET " << pinName << " + DIRECTION " << dir;
+    w << " + USE SIGNAL + LAYER M3 ( -100 0 ) ( 100 200 ) + PLACED ( " << x << " " << y << " ) N ;\n";
+  };
+
+  for(int b = 0; b < NUM_IO_BIT; b++)
+  {
+    int64_t y = (b + 1) * dieH / (NUM_IO_BIT + 2);
+    writeIO("din["  + std::to_string(b) + "]", "INPUT",  0,    y);
+    writeIO("dout[" + std::to_string(b) + "]", "OUTPUT", dieW, y);
+  }
+
+  writeIO("clk", "INPUT", 0, (NUM_IO_BIT + 1) * dieH / (NUM_IO_BIT + 2));
+
+  w << "END PINS\n";
+
+  if(opt_.writeNets)
+    writeNets(w);
+
+  w << "END DESIGN\n";
+}
+
+void
+Generator::writeCmd(const std::filesystem::path& dir) const
+{
+  Writer w(dir / (opt_.name + ".cmd"));
+
+  w << "read_lef "     << opt_.name << ".lef\n";
+  w << "read_verilog " << opt_.name << ".v\n";
+  w << "read_def "     << opt_.name << ".def\n";
+  w << "print_info\n";
+}
+
+void
+Generator::run()
+{
+  std::filesystem::path dir(opt_.outDir);
+  std::filesystem::create_directories(dir);
+
+  makeLibrary();
+
+  writeLef    (file(".lef"));
+  writeVerilog(file(".v"  ));
+  writeDef    (file(".def"));
+  writeCmd    (dir);
+
+  std::cout << "Generate " << opt_.name << " in " << opt_.outDir << std::endl;
+  std::cout << "  Instances : " << opt_.numInst << " (+ " << opt_.numBlock << " blocks)" << std::endl;
+  if(opt_.numBusWire > 0)
+    std::cout << "  Bus wires : " << opt_.numBusWire << " (unconnected)" << std::endl;
+  if(opt_.numDummy > 0)
+    std::cout << "  Dummies   : " << opt_.numDummy << " (DEF only)" << std::endl;
+  std::cout << "  Masters   : " << opt_.numLib  << std::endl;
+  std::cout << "  Rows      : " << numRow_ << " x " << numSite_ << " sites" << std::endl;
+  std::cout << "  Seed      : " << opt_.seed << std::endl;
+}
+
+} // namespace BenchGen
@@ -0,0 +1,182 @@
+#pragma once
+
+// Synthetic benchmark generator
+// Writes a consistent LEF / flat Verilog / DEF set (+ a .cmd script)
+// of the given scale. Every random choice is a hash of (seed, object, index),
+// so the output only depends on the options (not on the platform or the order of writing).
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <iostream>
+#include <filesystem>
+
+// Site of the library (um)
+#define SITE_W      0.2
+#define SITE_H      2.0
+#define DB_UNIT    1000
+
+// Number of primary input / output bits (din[], dout[])
+#define NUM_IO_BIT    32
+
+// Inputs come from one of the previous LOCAL_WINDOW instances
+// (global nets are made with the probability of 1 / GLOBAL_NET_RATIO)
+#define LOCAL_WINDOW     256
+#define GLOBAL_NET_RATIO  50
+
+// Every BUS_CHUNK instances, the next BUS_CHUNK drive the bits of a bus
+#define BUS_CHUNK         64
+
+// Alias wire (assign) / tie input (1'b0, 1'b1) period in instances
+#define ALIAS_PERIOD    1000
+#define TIE_PERIOD      5003
+
+// Pins of a block macro (A[0..] inputs, Y[0..] outputs)
+#define BLOCK_PIN_BIT      8
+
+namespace BenchGen
+{
+
+struct Option
+{
+  std::string outDir;
+  std::string name     = "bench";
+
+  int64_t  numInst     = 100000;                            // Standard cell instances
+  int      numLib      = 32;                                // Standard cell masters
+  int      numBlock    = 4;                                 // Block macro instances
+  double   util        = 0.7;
+  uint64_t seed        = 1;
+  bool     writeNets   = false;                             // NETS section in DEF
+  int64_t  numBusWire  = 0;                                 // Extra unconnected bus wires (width 2 ~ 9)
+  int64_t  numDummy    = 0;                                 // DEF components not in the Verilog
+                                                            // (as in the ICCAD 2015 superblue)
+};
+
+// Standard cell master
+struct Master
+{
+  std::string name;
+  int  numInput;
+  int  widthSite;
+  bool isSeq;                                               // D, CK -> Q
+};
+
+// Buffered output (much faster than fprintf for 10M+ lines)
+class Writer
+{
+  public:
+
+    Writer(const std::filesystem::path& path)
+    {
+      fp_ = std::fopen(path.c_str(), "wb");
+
+      if(fp_ == nullptr)
+      {
+        std::cout << "Failed to open " << std::string(path) << std::endl;
+        exit(1);
+      }
+
+      buffer_.reserve(1 << 20);
+    }
+
+    ~Writer()
+    {
+      flush();
+      std::fclose(fp_);
+    }
+
+    Writer& operator<<(std::string_view str)
+    {
+      buffer_.append(str.data(), str.size());
+      if(buffer_.size() >= (1 << 20))
+        flush();
+      return *this;
+    }
+
+    Writer& operator<<(int64_t value)
+    {
+      char str[24];
+      auto [end, ec] = std::to_chars(str, str + sizeof(str), value);
+      return *this << std::string_view(str, end - str);
+    }
+
+    Writer& operator<<(int value) { return *this << static_cast<int64_t>(value); }
+
+    // Fixed-point number in um (dbu / DB_UNIT)
+    Writer& micron(int64_t dbu)
+    {
+      char str[32];
+      snprintf(str, sizeof(str), "%.3f", double(dbu) / DB_UNIT);
+      return *this << std::string_view(str);
+    }
+
+  private:
+
+    FILE*       fp_;
+    std::string buffer_;
+
+    void flush()
+    {
+      std::fwrite(buffer_.data(), 1, buffer_.size(), fp_);
+      buffer_.clear();
+    }
+};
+
+class Generator
+{
+  public:
+
+    Generator(const Option& opt) : opt_ (opt) {}
+
+    void run();
+
+    // <outDir>/<name><ext> (e.g. ".lef", ".v", ".def", ".cmd")
+    std::filesystem::path file(const std::string& ext) const
+    { return std::filesystem::path(opt_.outDir) / (opt_.name + ext); }
+
+  private:
+
+    Option opt_;
+
+    std::vector<Master>  masters_;
+    std::vector<uint8_t> instMaster_;                       // Master of each instance
+
+    int64_t siteW_;                                         // dbu
+    int64_t siteH_;
+    int64_t blockW_;
+    int64_t blockH_;
+
+    int64_t numRow_;
+    int64_t numSite_;                                       // Sites per row
+
+    // Net ID of the driver (connections are computed, not stored)
+    //   [0, numInst)          : output of instance i
+    //   numInst + b           : din[b]
+    //   numInst + NUM_IO_BIT  : clk
+    //   TIE0 / TIE1
+    static constexpr int64_t TIE0 = -1;
+    static constexpr int64_t TIE1 = -2;
+
+    int64_t clkNet() const { return opt_.numInst + NUM_IO_BIT; }
+    int64_t numNet() const { return opt_.numInst + NUM_IO_BIT + 1; }
+
+    int64_t inputNet(int64_t inst, int pin) const;          // Driver of an input pin of a standard cell
+    int64_t blockNet(int block, int bit)    const;          // Driver of A[bit] of a block
+
+    void netName(Writer& w, int64_t net, bool useAlias) const;
+
+    void makeLibrary();
+    void writeLef    (const std::filesystem::path& path) const;
+    void writeVerilog(const std::filesystem::path& path) const;
+    void writeDef    (const std::filesystem::path& path) const;
+    void writeCmd    (const std::filesystem::path& dir)  const;
+
+    void writeNets   (Writer& w) const;
+};
+
+} // namespace BenchGen
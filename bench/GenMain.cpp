@@ -0,0 +1,63 @@
+// Parser_gen -o <dir> [-inst 100000] [-lib 32] [-block 4] [-util 0.7]
+//                     [-seed 1] [-nets] [-bus_wires 0] [-dummy 0] [-name bench]
+
+#include <string>
+#include <iostream>
+
+#include "BenchGen.h"
+
+int main(int argc, char** argv)
+{
+  BenchGen::Option opt;
+
+  auto usage = [] ()
+  {
+    std::cout << "Usage: Parser_gen -o <dir> [-inst 100000] [-lib 32] [-block 4]" << std::endl;
+    std::cout << "                  [-util 0.7] [-seed 1] [-nets] [-bus_wires 0] [-dummy 0] [-name bench]" << std::endl;
+    exit(1);
+  };
+
+  for(int i = 1; i < argc; i++)
+  {
+    std::string flag = argv[i];
+
+    auto arg = [&] () -> std::string
+    {
+      if(i + 1 >= argc)
+        usage();
+      return argv[++i];
+    };
+
+    if(flag == "-o")
+      opt.outDir = arg();
+    else if(flag == "-name")
+      opt.name = arg();
+    else if(flag == "-inst")
+      opt.numInst = std::stoll(arg());
+    else if(flag == "-lib")
+      opt.numLib = std::stoi(arg());
+    else if(flag == "-block")
+      opt.numBlock = std::stoi(arg());
+    else if(flag == "-util")
+      opt.util = std::stod(arg());
+    else if(flag == "-seed")
+      opt.seed = std::stoull(arg());
+    else if(flag == "-nets")
+      opt.writeNets = true;
+    else if(flag == "-bus_wires")
+      opt.numBusWire = std::stoll(arg());
+    else if(flag == "-dummy")
+      opt.numDummy = std::stoll(arg());
+    else
+      usage();
+  }
+
+  if(opt.outDir.empty() || opt.numInst < 0 || opt.numBlock < 0 || opt.numDummy < 0 || opt.numBusWire < 0
+  || opt.numLib < 1 || opt.numLib > 250 || opt.util <= 0.0 || opt.util > 1.0)
+    usage();
+
+  BenchGen::Generator gen(opt);
+  gen.run();
+
+  return 0;
+}
@@ -0,0 +1,843 @@
+// Parser_bench [-inst 100000] [-seed 1] [-min_time 0.5] [-threads 1]
+//              [-size 1024x1024] [-filter xx] [-o dir]
+//
+// Microbenchmarks of the parsing / drawing stages
+// on a design made by the synthetic generator (bench/BenchGen).
+// Every benchmark is repeated until it has run for at least min_time,
+// and reports the mean time per iteration and its throughput.
+
+#include <cstdio>
+#include <cctype>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <unistd.h>
+
+#include "BenchGen.h"
+#include "LefDefParser.h"
+#include "Painter.h"
+#include "Profiler.h"
+#include "Wirelength.h"
+#include "GridIndex.h"
+#include "RTree.h"
+
+using namespace LefDefDB;
+using namespace Graphic;
+
+// Amount of work done by one iteration (0 : not reported)
+struct Counters
+{
+  double bytes   = 0;
+  double tokens  = 0;
+  double objects = 0;
+};
+
+class ParserBench
+{
+  public:
+
+    struct Option
+    {
+      int64_t     numInst    = 100000;
+      uint64_t    seed       = 1;
+      double      minTime    = 0.5;                         // s
+      int         numThreads = 1;                           // drawCells
+      int         width      = 1024;
+      int         height     = 1024;
+      std::string filter;                                   // Only benchmarks containing this
+      std::string outDir;                                   // Temporary directory if empty
+    };
+
+    ParserBench(const Option& opt) : opt_ (opt) {}
+
+    void run();
+
+  private:
+
+    Option opt_;
+
+    std::filesystem::path lef_;
+    std::filesystem::path verilog_;
+    std::filesystem::path def_;
+
+    std::shared_ptr<LefDefParser> db_;                      // LEF + Verilog + DEF
+
+    void generate();
+    void load();
+
+    void printHeader() const;
+
+    // body() returns the seconds of its timed part
+    // (so the preparation of each iteration is not counted)
+    void bench(const std::string& name, const Counters& counters,
+               const std::function<double()>& body);
+
+    void benchTokenize();
+    void benchConversion();
+    void benchLookup();
+    void benchLefMacro();
+    void benchDefComponent();
+    void benchVerilog();
+    void benchBusDecl();
+    void benchDrawCells();
+    void benchWirelength();
+    void benchGridIndex();
+    void benchRTree();
+};
+
+// Seconds taken by func()
+template<typename Func>
+static double timed(Func func)
+{
+  auto t1 = std::chrono::steady_clock::now();
+  func();
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+  return runtime.count();
+}
+
+// Parser messages ("Read xx...") are not printed while benchmarking
+class MuteCout
+{
+  public:
+
+    MuteCout()  : buf_ (std::cout.rdbuf(nullptr)) {}
+    ~MuteCout() { std::cout.rdbuf(buf_); }
+
+  private:
+
+    std::streambuf* buf_;
+};
+
+static std::string rate(double amount, double seconds, double unit, const char* suffix)
+{
+  if(amount == 0)
+    return "-";
+
+  char str[32];
+  snprintf(str, sizeof(str), "%.2f%s", amount / seconds / unit, suffix);
+  return str;
+}
+
+void
+ParserBench::printHeader() const
+{
+  printf("%-34s %12s %10s %14s %12s %14s\n",
+         "Benchmark", "Time (ms)", "Iterations", "Tokens/s", "MB/s", "Objects/s");
+  printf("%s\n", std::string(101, '-').c_str());
+}
+
+void
+ParserBench::bench(const std::string& name, const Counters& counters,
+                   const std::function<double()>& body)
+{
+  if(!opt_.filter.empty() && name.find(opt_.filter) == std::string::npos)
+    return;
+
+  int    iterations = 0;
+  double total      = 0.0;
+
+  {
+    MuteCout mute;
+
+    while(iterations == 0 || total < opt_.minTime)
+    {
+      total += body();
+      iterations++;
+    }
+  }
+
+  double perIter = total / iterations;
+
+  printf("%-34s %12.3f %10d %14s %12s %14s\n",
+         name.c_str(), perIter * 1e3, iterations,
+         rate(counters.tokens,  perIter, 1e6,         "M").c_str(),
+         rate(counters.bytes,   perIter, 1024 * 1024, "" ).c_str(),
+         rate(counters.objects, perIter, 1e6,         "M").c_str());
+
+  fflush(stdout);
+}
+
+void
+ParserBench::generate()
+{
+  bool isTemp = opt_.outDir.empty();
+
+  if(isTemp)
+  {
+    auto dir = std::filesystem::temp_directory_path()
+             / ("parser_bench_" + std::to_string(getpid()));
+    opt_.outDir = dir.string();
+  }
+
+  BenchGen::Option genOpt;
+  genOpt.outDir  = opt_.outDir;
+  genOpt.numInst = opt_.numInst;
+  genOpt.seed    = opt_.seed;
+
+  BenchGen::Generator gen(genOpt);
+  gen.run();
+
+  lef_     = gen.file(".lef");
+  verilog_ = gen.file(".v");
+  def_     = gen.file(".def");
+}
+
+void
+ParserBench::load()
+{
+  MuteCout mute;
+
+  db_ = std::make_shared<LefDefParser>();
+
+  Status status = db_->readLef(lef_);
+
+  if(status)
+    status = db_->readVerilog(verilog_);
+  if(status)
+    status = db_->readDef(def_);
+
+  if(!status)
+  {
+    std::cerr << status.message() << std::endl;
+    exit(1);
+  }
+}
+
+void
+ParserBench::benchTokenize()
+{
+  struct Input
+  {
+    const char*                  name;
+    const std::filesystem::path& path;
+    LefDefParser::FileType       type;
+  };
+
+  const Input inputs[] =
+  {
+    {"tokenize/lef",     lef_,     LefDefParser::FileType::LEF    },
+    {"tokenize/verilog", verilog_, LefDefParser::FileType::VERILOG},
+    {"tokenize/def",     def_,     LefDefParser::FileType::DEF    }
+  };
+
+  for(const Input& input : inputs)
+  {
+    std::vector<std::string> tokens = db_->tokenize(input.path, input.type);
+
+    Counters counters;
+    counters.bytes  = std::filesystem::file_size(input.path);
+    counters.tokens = tokens.size();
+
+    bench(input.name, counters, [&] ()
+    {
+      tokens.clear();
+      tokens.shrink_to_fit();
+
+      return timed([&] () { tokens = db_->tokenize(input.path, input.type); });
+    });
+  }
+}
+
+void
+ParserBench::benchConversion()
+{
+  auto isNumber = [] (const std::string& str)
+  {
+    size_t i = (str[0] == '-') ? 1 : 0;
+    return i < str.size() && std::isdigit(static_cast<unsigned char>(str[i]));
+  };
+
+  // Integers of DEF (coordinates) and reals of LEF (um)
+  std::vector<std::string> ints;
+  std::vector<std::string> reals;
+
+  for(auto& token : db_->tokenize(def_, LefDefParser::FileType::DEF))
+    if(isNumber(token))
+      ints.push_back(token);
+
+  for(auto& token : db_->tokenize(lef_, LefDefParser::FileType::LEF))
+    if(isNumber(token) && token.find('.') != std::string::npos)
+      reals.push_back(token);
+
+  Counters counters;
+
+  // The sums are used after the loops (so they are not optimized out)
+  long long sumInt = 0;
+
+  counters.objects = ints.size();
+  bench("convert/stoi", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(const auto& str : ints)
+        sumInt += std::stoi(str);
+    });
+  });
+
+  double sumReal = 0.0;
+
+  counters.objects = reals.size();
+  bench("convert/stof", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(const auto& str : reals)
+        sumReal += std::stof(str);
+    });
+  });
+
+  if(sumInt == 1 && sumReal == 1.0)
+    printf("\n");
+}
+
+void
+ParserBench::benchLookup()
+{
+  // Every net name in a random order
+  std::vector<std::string> netNames;
+  netNames.reserve(db_->nets().size());
+
+  for(const dbNet* net : db_->nets())
+    netNames.push_back(net->name());
+
+  std::shuffle(netNames.begin(), netNames.end(), std::mt19937(opt_.seed));
+
+  // Master of every instance in the netlist order
+  std::vector<std::string> macroNames;
+  macroNames.reserve(db_->cells().size());
+
+  for(const dbCell* cell : db_->cells())
+    macroNames.push_back(cell->lefMacro()->name());
+
+  long long sum = 0;
+
+  Counters counters;
+
+  counters.objects = netNames.size();
+  bench("lookup/findNetID", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(const auto& name : netNames)
+        sum += db_->findNetID(name);
+    });
+  });
+
+  counters.objects = macroNames.size();
+  bench("lookup/findMacro", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(const auto& name : macroNames)
+        sum += db_->findMacro(name)->sizeX() > 0;
+    });
+  });
+
+  if(sum == 1)
+    printf("\n");
+}
+
+void
+ParserBench::benchLefMacro()
+{
+  // SITE / UNITS are needed by readLefMacros
+  LefDefParser lefDb;
+
+  {
+    MuteCout mute;
+    (void)lefDb.readLef(lef_);
+  }
+
+  const std::vector<std::string> tokens = lefDb.tokenize(lef_, LefDefParser::FileType::LEF);
+
+  Counters counters;
+  counters.bytes   = std::filesystem::file_size(lef_);
+  counters.tokens  = tokens.size();
+  counters.objects = std::count(tokens.begin(), tokens.end(), "MACRO");
+
+  std::vector<std::string> copy;
+
+  Status status;
+
+  // Tokens are moved by the reader (copied for each iteration)
+  bench("readLefMacros", counters, [&] ()
+  {
+    copy = tokens;
+    return timed([&] () { status = lefDb.readLefMacros(copy); });
+  });
+
+  if(!status)
+    std::cerr << status.message() << std::endl;
+}
+
+void
+ParserBench::benchDefComponent()
+{
+  const std::vector<std::string> tokens = db_->tokenize(def_, LefDefParser::FileType::DEF);
+
+  // COMPONENTS xx ; ... END COMPONENTS
+  auto first = std::find(tokens.begin(), tokens.end(), "COMPONENTS");
+
+  if(first == tokens.end())
+  {
+    std::cout << "No COMPONENTS in " << std::string(def_) << std::endl;
+    exit(0);
+  }
+
+  auto last = first + 1;
+
+  while(last + 1 < tokens.end() && !(*last == "END" && *(last + 1) == "COMPONENTS"))
+    ++last;
+
+  last = std::min(last + 2, tokens.end());
+
+  const int numComp = std::count(first, last, "-");
+
+  Counters counters;
+  counters.tokens  = last - first;
+  counters.objects = numComp;
+
+  std::vector<std::string> copy;
+
+  Status status;
+
+  // The same placement is written to the same cells again
+  bench("readDefComponents", counters, [&] ()
+  {
+    copy.assign(first, last);
+
+    MuteCout mute; // No progress message
+    return timed([&] () { status = db_->readDefComponents(copy); });
+  });
+
+  if(!status)
+    std::cerr << status.message() << std::endl;
+}
+
+void
+ParserBench::benchVerilog()
+{
+  // The instance loop is the "parse" phase of readVerilog
+  // (after tokenize, before flatten / assign / fixup)
+  Counters counters;
+  counters.bytes   = std::filesystem::file_size(verilog_);
+  counters.objects = db_->cells().size();
+
+  bench("readVerilog/parse", counters, [&] ()
+  {
+    auto db = std::make_unique<LefDefParser>();
+    (void)db->readLef(lef_);
+
+    Profiler::Entry before;
+    Profiler::Entry after;
+    Profiler::findEntry("bench_verilog/parse", before);
+
+    {
+      ProfileScope scope("bench_verilog");
+      (void)db->readVerilog(verilog_);
+    }
+
+    Profiler::findEntry("bench_verilog/parse", after);
+
+    return after.wallTime - before.wallTime;
+  });
+}
+
+void
+ParserBench::benchBusDecl()
+{
+  // Declaration-heavy netlist : 100k unconnected bus wires of width 2 ~ 9
+  const int64_t numBusWire = 100000;
+
+  BenchGen::Option genOpt;
+  genOpt.outDir     = (std::filesystem::path(opt_.outDir) / "bus").string();
+  genOpt.name       = "bus";
+  genOpt.numInst    = 1000;
+  genOpt.seed       = opt_.seed;
+  genOpt.numBusWire = numBusWire;
+
+  BenchGen::Generator gen(genOpt);
+
+  {
+    MuteCout mute;
+    gen.run();
+  }
+
+  std::filesystem::path lef     = gen.file(".lef");
+  std::filesystem::path verilog = gen.file(".v");
+
+  Counters counters;
+  counters.bytes   = std::filesystem::file_size(verilog);
+  counters.objects = numBusWire;
+
+  bench("readVerilog/busDecl:" + std::to_string(numBusWire), counters, [&] ()
+  {
+    auto db = std::make_unique<LefDefParser>();
+    (void)db->readLef(lef);
+
+    return timed([&] () { (void)db->readVerilog(verilog); });
+  });
+}
+
+void
+ParserBench::benchDrawCells()
+{
+  Painter painter(db_);
+  painter.prepareCanvas(opt_.width, opt_.height);
+
+  Counters counters;
+  counters.objects = db_->cells().size();
+
+  std::string name = "drawCells/" + std::to_string(opt_.width) + "x"
+                                  + std::to_string(opt_.height) + "/threads:"
+                                  + std::to_string(opt_.numThreads);
+
+  bench(name, counters, [&] ()
+  {
+    painter.resetCanvas();
+    return timed([&] () { painter.rasterCells(opt_.numThreads); });
+  });
+}
+
+void
+ParserBench::benchWirelength()
+{
+  db_->setNumThreads(opt_.numThreads);
+
+  Wirelength wl(db_);
+
+  Counters counters;
+  counters.objects = db_->nets().size();
+
+  bench("hpwl/full/threads:" + std::to_string(opt_.numThreads), counters, [&] ()
+  {
+    return timed([&] () { (void)wl.computeHpwl(); });
+  });
+
+  db_->setNumThreads(1);
+
+  // Random moves within +-10 um of the cells (none is committed)
+  const int numMove = 100000;
+  const int numCell = db_->cells().size();
+  const int range   = 10 * db_->dbUnit();
+
+  std::mt19937 rng(opt_.seed);
+
+  std::vector<int> cellIDs(numMove);
+  std::vector<int> newX(numMove);
+  std::vector<int> newY(numMove);
+
+  for(int i = 0; i < numMove; i++)
+  {
+    const dbCell* cell = db_->cells()[rng() % numCell];
+
+    cellIDs[i] = cell->id();
+    newX[i]    = cell->lx() + static_cast<int>(rng() % (2 * range + 1)) - range;
+    newY[i]    = cell->ly() + static_cast<int>(rng() % (2 * range + 1)) - range;
+  }
+
+  counters.objects = numMove;
+
+  double sink = 0.0;
+
+  bench("hpwl/evaluateMove", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(int i = 0; i < numMove; i++)
+        sink += wl.evaluateMove(cellIDs[i], newX[i], newY[i]);
+    });
+  });
+
+  if(sink == 1.0)
+    printf("\n");
+}
+
+void
+ParserBench::benchGridIndex()
+{
+  db_->setNumThreads(opt_.numThreads);
+
+  GridIndex grid(db_);
+
+  Counters counters;
+  counters.objects = db_->cells().size() + db_->pins().size();
+
+  bench("grid/build/threads:" + std::to_string(opt_.numThreads), counters, [&] ()
+  {
+    return timed([&] () { (void)grid.build(); });
+  });
+
+  db_->setNumThreads(1);
+
+  // Random 10 um x 10 um boxes / points in the die
+  const int numQuery = 100000;
+  const int range    = 10 * db_->dbUnit();
+  const dbDie* die   = db_->die();
+
+  std::mt19937 rng(opt_.seed);
+
+  std::vector<int> queryX(numQuery);
+  std::vector<int> queryY(numQuery);
+
+  for(int i = 0; i < numQuery; i++)
+  {
+    queryX[i] = die->lx() + static_cast<int>(rng() % std::max(1, die->ux() - die->lx()));
+    queryY[i] = die->ly() + static_cast<int>(rng() % std::max(1, die->uy() - die->ly()));
+  }
+
+  counters.objects = numQuery;
+
+  std::vector<int> found;
+  size_t sink = 0;
+
+  bench("grid/cellsInBox", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(int i = 0; i < numQuery; i++)
+      {
+        found.clear();
+        grid.cellsInBox(queryX[i], queryY[i], queryX[i] + range, queryY[i] + range, found);
+        sink += found.size();
+      }
+    });
+  });
+
+  bench("grid/nearestCell", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(int i = 0; i < numQuery; i++)
+        sink += grid.nearestCell(queryX[i], queryY[i]);
+    });
+  });
+
+  bench("grid/nearestPin", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(int i = 0; i < numQuery; i++)
+        sink += grid.nearestPin(queryX[i], queryY[i]);
+    });
+  });
+
+  if(sink == 1)
+    printf("\n");
+}
+
+void
+ParserBench::benchRTree()
+{
+  RTree tree(db_);
+
+  // Fixed macros + IO pins of the design
+  Counters counters;
+
+  bench("rtree/build/design", counters, [&] ()
+  {
+    return timed([&] () { (void)tree.build(); });
+  });
+
+  // Free segments of every row
+  std::vector<std::pair<int, int>> segments;
+  size_t sink = 0;
+
+  counters.objects = db_->rows().size();
+
+  bench("rtree/freeSegments/rows", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(const dbRow* row : db_->rows())
+      {
+        tree.freeSegments(row->origX(), row->origY(),
+                          row->origX() + row->sizeX(), row->origY() + row->sizeY(), segments);
+        sink += segments.size();
+      }
+    });
+  });
+
+  // Random boxes of 1 ~ 20 um over the die (as many as the instances)
+  const dbDie* die    = db_->die();
+  const int    dieW   = std::max(1, die->ux() - die->lx());
+  const int    dieH   = std::max(1, die->uy() - die->ly());
+  const int    maxLen = 20 * db_->dbUnit();
+
+  std::mt19937 rng(opt_.seed);
+
+  std::vector<RTree::Object> objects(opt_.numInst);
+
+  for(int i = 0; i < opt_.numInst; i++)
+  {
+    RTree::Object& o = objects[i];
+
+    o.lx   = die->lx() + static_cast<int>(rng() % dieW);
+    o.ly   = die->ly() + static_cast<int>(rng() % dieH);
+    o.ux   = o.lx + 1 + static_cast<int>(rng() % maxLen);
+    o.uy   = o.ly + 1 + static_cast<int>(rng() % maxLen);
+    o.kind = RTree::Kind::Macro;
+    o.id   = i;
+  }
+
+  counters.objects = objects.size();
+
+  bench("rtree/build/random", counters, [&] ()
+  {
+    return timed([&] () { tree.build(objects); });
+  });
+
+  // 10 um x 10 um queries
+  const int numQuery = 10000;
+  const int range    = 10 * db_->dbUnit();
+
+  std::vector<int> queryX(numQuery);
+  std::vector<int> queryY(numQuery);
+
+  for(int i = 0; i < numQuery; i++)
+  {
+    queryX[i] = die->lx() + static_cast<int>(rng() % dieW);
+    queryY[i] = die->ly() + static_cast<int>(rng() % dieH);
+  }
+
+  counters.objects = numQuery;
+
+  std::vector<int> found;
+
+  bench("rtree/overlapping/random", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(int i = 0; i < numQuery; i++)
+      {
+        found.clear();
+        tree.overlapping(queryX[i], queryY[i], queryX[i] + range, queryY[i] + range, found);
+        sink += found.size();
+      }
+    });
+  });
+
+  bench("rtree/overlapping/bruteforce", counters, [&] ()
+  {
+    return timed([&] ()
+    {
+      for(int i = 0; i < numQuery; i++)
+      {
+        const int lx = queryX[i];
+        const int ly = queryY[i];
+        const int ux = lx + range;
+        const int uy = ly + range;
+
+        found.clear();
+
+        for(const RTree::Object& o : objects)
+        {
+          if(o.lx < ux && o.ux > lx && o.ly < uy && o.uy > ly)
+            found.push_back(o.id);
+        }
+
+        sink += found.size();
+      }
+    });
+  });
+
+  if(sink == 1)
+    printf("\n");
+}
+
+void
+ParserBench::run()
+{
+  bool isTemp = opt_.outDir.empty();
+
+  generate();
+
+  std::cout << "Loading the design..." << std::endl;
+  load();
+
+  std::cout << std::endl;
+  printHeader();
+
+  benchTokenize();
+  benchConversion();
+  benchLookup();
+  benchLefMacro();
+  benchDefComponent();
+  benchVerilog();
+  benchBusDecl();
+  benchDrawCells();
+  benchWirelength();
+  benchGridIndex();
+  benchRTree();
+
+  if(isTemp)
+    std::filesystem::remove_all(opt_.outDir);
+}
+
+int main(int argc, char** argv)
+{
+  ParserBench::Option opt;
+
+  auto usage = [] ()
+  {
+    std::cout << "Usage: Parser_bench [-inst 100000] [-seed 1] [-min_time 0.5] [-threads 1]" << std::endl;
+    std::cout << "                    [-size 1024x1024] [-filter xx] [-o dir]" << std::endl;
+    exit(1);
+  };
+
+  for(int i = 1; i < argc; i++)
+  {
+    std::string flag = argv[i];
+
+    auto arg = [&] () -> std::string
+    {
+      if(i + 1 >= argc)
+        usage();
+      return argv[++i];
+    };
+
+    if(flag == "-inst")
+      opt.numInst = std::stoll(arg());
+    else if(flag == "-seed")
+      opt.seed = std::stoull(arg());
+    else if(flag == "-min_time")
+      opt.minTime = std::stod(arg());
+    else if(flag == "-threads")
+      opt.numThreads = std::stoi(arg());
+    else if(flag == "-filter")
+      opt.filter = arg();
+    else if(flag == "-o")
+      opt.outDir = arg();
+    else if(flag == "-size")
+    {
+      std::string size = arg();
+      size_t x = size.find('x');
+
+      if(x == std::string::npos)
+        usage();
+
+      opt.width  = std::stoi(size.substr(0, x));
+      opt.height = std::stoi(size.substr(x + 1));
+    }
+    else
+      usage();
+  }
+
+  if(opt.numInst < 1 || opt.numThreads < 1 || opt.minTime < 0.0
+  || opt.width < 64 || opt.height < 64)
+    usage();
+
+  ParserBench bench(opt);
+  bench.run();
+
+  return 0;
+}
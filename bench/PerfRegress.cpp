@@ -0,0 +1,375 @@
+// Parser_regress -parser <Parser> -baseline <file> -dir <work dir>
+//                [-repeat 3] [-time_tol 0.25] [-rss_tol 0.15] [-update]
+//
+// End-to-end performance regression test
+// Every case of the baseline file is generated by the synthetic generator
+// and its .cmd script is run by the Parser executable.
+// Wall time, peak RSS and the print_info statistics are compared
+// with the baseline, and the exit code is 1 if any of them regresses.
+// (-update writes the current results to the baseline file instead)
+
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "BenchGen.h"
+
+// One line of the baseline file
+struct PerfCase
+{
+  // Input
+  std::string name;
+  int64_t     numInst     = 0;
+  uint64_t    seed        = 1;
+  bool        writeNets   = false;                          // NETS section in DEF
+  int64_t     numDummy    = 0;                              // DEF components not in the Verilog
+
+  // Result
+  double      wallTime    = 0.0;                            // s
+  double      peakRss     = 0.0;                            // MB
+  int64_t     numInstance = -1;                             // print_info
+  int64_t     numNet      = -1;
+  int64_t     numPin      = -1;
+  double      util        = -1.0;                           // %
+  double      density     = -1.0;                           // %
+};
+
+struct RegressOption
+{
+  std::string parser;
+  std::string baseline;
+  std::string workDir;
+
+  int    numRepeat = 3;                                     // Minimum of the runs is taken
+  double timeTol   = 0.25;                                  // Relative
+  double timeSlack = 0.05;                                  // s (for the noise of small cases)
+  double rssTol    = 0.15;                                  // Relative
+  double ratioTol  = 0.01;                                  // UTIL / DENSITY (absolute %)
+  bool   update    = false;
+};
+
+static const char* baselineHeader =
+  "# Baseline of perf_regress (update with 'make perf_regress_update')\n"
+  "# name     inst  seed  nets  dummy  wall(s)  rss(MB)  NUM_INSTANCE  NUM_NET  NUM_PIN  UTIL(%)  DENSITY(%)\n";
+
+static std::vector<PerfCase> readBaseline(const std::string& fileName)
+{
+  std::ifstream ifs(fileName);
+
+  if(!ifs.good())
+  {
+    std::cout << "Failed to open " << fileName << std::endl;
+    exit(1);
+  }
+
+  std::vector<PerfCase> cases;
+  std::string line;
+
+  while(std::getline(ifs, line))
+  {
+    if(line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream iss(line);
+
+    PerfCase c;
+    int nets = 0;
+
+    iss >> c.name >> c.numInst >> c.seed >> nets >> c.numDummy
+        >> c.wallTime >> c.peakRss
+        >> c.numInstance >> c.numNet >> c.numPin
+        >> c.util >> c.density;
+
+    if(iss.fail())
+    {
+      std::cout << "Syntax error in " << fileName << " : " << line << std::endl;
+      exit(1);
+    }
+
+    c.writeNets = (nets != 0);
+    cases.push_back(c);
+  }
+
+  return cases;
+}
+
+static void writeBaseline(const std::string& fileName, const std::vector<PerfCase>& cases)
+{
+  FILE* fp = std::fopen(fileName.c_str(), "w");
+
+  if(fp == nullptr)
+  {
+    std::cout << "Failed to open " << fileName << std::endl;
+    exit(1);
+  }
+
+  std::fputs(baselineHeader, fp);
+
+  for(const PerfCase& c : cases)
+  {
+    std::fprintf(fp, "%-8s %7lld %5llu %5d %6lld %8.3f %8.1f %13lld %8lld %8lld %8.2f %11.2f\n",
+                 c.name.c_str(), (long long)c.numInst, (unsigned long long)c.seed,
+                 c.writeNets ? 1 : 0, (long long)c.numDummy, c.wallTime, c.peakRss,
+                 (long long)c.numInstance, (long long)c.numNet, (long long)c.numPin,
+                 c.util, c.density);
+  }
+
+  std::fclose(fp);
+}
+
+// Runs "parser cmdFile" in dir
+// and returns the output (wall time and peak RSS of the child in c)
+static std::string runParser(const std::string& parser,
+                             const std::filesystem::path& dir,
+                             const std::string& cmdFile,
+                             PerfCase& c)
+{
+  int fd[2];
+
+  if(pipe(fd) != 0)
+  {
+    std::cout << "Failed to make a pipe" << std::endl;
+    exit(1);
+  }
+
+  auto t1 = std::chrono::steady_clock::now();
+
+  pid_t pid = fork();
+
+  if(pid == 0)
+  {
+    dup2(fd[1], STDOUT_FILENO);
+    dup2(fd[1], STDERR_FILENO);
+    close(fd[0]);
+    close(fd[1]);
+
+    if(chdir(dir.c_str()) == 0)
+      execl(parser.c_str(), parser.c_str(), cmdFile.c_str(), (char*)nullptr);
+
+    _exit(127);
+  }
+
+  close(fd[1]);
+
+  std::string output;
+  char buffer[4096];
+  ssize_t size;
+
+  while((size = read(fd[0], buffer, sizeof(buffer))) > 0)
+    output.append(buffer, size);
+
+  close(fd[0]);
+
+  int status;
+  struct rusage usage;
+  wait4(pid, &status, 0, &usage);
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+
+  c.wallTime = runtime.count();
+  c.peakRss  = usage.ru_maxrss / 1024.0; // KB on Linux
+
+  if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+  {
+    std::cout << output << std::endl;
+    std::cout << "Parser failed on " << dir.string() << std::endl;
+    exit(1);
+  }
+
+  return output;
+}
+
+// Statistics of the last print_info (-1 if missing)
+static void readSummary(const std::string& output, PerfCase& c)
+{
+  auto value = [&] (const std::string& key) -> std::string
+  {
+    size_t pos = output.rfind(" " + key + " ");
+
+    if(pos == std::string::npos)
+      return "-1";
+
+    pos = output.find(':', pos);
+    size_t end = output.find_first_of("%\n", pos);
+
+    return output.substr(pos + 1, end - pos - 1);
+  };
+
+  c.numInstance = std::stoll(value("NUM INSTANCE"));
+  c.numNet      = std::stoll(value("NUM NET"));
+  c.numPin      = std::stoll(value("NUM PIN"));
+  c.util        = std::stod (value("UTIL"));
+  c.density     = std::stod (value("DENSITIY"));
+}
+
+static PerfCase runCase(const RegressOption& opt, const PerfCase& base)
+{
+  std::filesystem::path dir = std::filesystem::path(opt.workDir) / base.name;
+
+  BenchGen::Option genOpt;
+  genOpt.outDir    = dir.string();
+  genOpt.name      = base.name;
+  genOpt.numInst   = base.numInst;
+  genOpt.seed      = base.seed;
+  genOpt.writeNets = base.writeNets;
+  genOpt.numDummy  = base.numDummy;
+
+  BenchGen::Generator gen(genOpt);
+
+  std::streambuf* buf = std::cout.rdbuf(nullptr);
+  gen.run();
+  std::cout.rdbuf(buf);
+
+  PerfCase best = base;
+  best.wallTime = HUGE_VAL;
+
+  for(int i = 0; i < opt.numRepeat; i++)
+  {
+    PerfCase cur = base;
+
+    std::string output = runParser(opt.parser, dir, base.name + ".cmd", cur);
+    readSummary(output, cur);
+
+    if(cur.wallTime < best.wallTime)
+      best = cur;
+  }
+
+  return best;
+}
+
+// Returns false if any metric of cur regresses from base
+static bool compare(const RegressOption& opt, const PerfCase& base, const PerfCase& cur)
+{
+  bool success = true;
+
+  auto row = [&] (const char* metric, double baseVal, double curVal,
+                  double limit, bool isPass, int precision)
+  {
+    printf("  %-10s %-14s %14.*f %14.*f %14.*f   %s\n",
+           base.name.c_str(), metric,
+           precision, baseVal, precision, curVal, precision, limit,
+           isPass ? "ok" : "FAIL");
+
+    success &= isPass;
+  };
+
+  double timeLimit = base.wallTime * (1.0 + opt.timeTol) + opt.timeSlack;
+  double rssLimit  = base.peakRss  * (1.0 + opt.rssTol);
+
+  row("wall (s)",     base.wallTime, cur.wallTime, timeLimit, cur.wallTime <= timeLimit, 3);
+  row("rss (MB)",     base.peakRss,  cur.peakRss,  rssLimit,  cur.peakRss  <= rssLimit,  1);
+
+  row("NUM INSTANCE", base.numInstance, cur.numInstance, base.numInstance,
+                      cur.numInstance == base.numInstance, 0);
+  row("NUM NET",      base.numNet,      cur.numNet,      base.numNet,
+                      cur.numNet      == base.numNet,      0);
+  row("NUM PIN",      base.numPin,      cur.numPin,      base.numPin,
+                      cur.numPin      == base.numPin,      0);
+
+  row("UTIL (%)",     base.util,    cur.util,    opt.ratioTol,
+                      std::fabs(cur.util    - base.util)    <= opt.ratioTol, 2);
+  row("DENSITY (%)",  base.density, cur.density, opt.ratioTol,
+                      std::fabs(cur.density - base.density) <= opt.ratioTol, 2);
+
+  return success;
+}
+
+int main(int argc, char** argv)
+{
+  RegressOption opt;
+
+  auto usage = [] ()
+  {
+    std::cout << "Usage: Parser_regress -parser <Parser> -baseline <file> -dir <work dir>" << std::endl;
+    std::cout << "                      [-repeat 3] [-time_tol 0.25] [-rss_tol 0.15] [-update]" << std::endl;
+    exit(1);
+  };
+
+  for(int i = 1; i < argc; i++)
+  {
+    std::string flag = argv[i];
+
+    auto arg = [&] () -> std::string
+    {
+      if(i + 1 >= argc)
+        usage();
+      return argv[++i];
+    };
+
+    if(flag == "-parser")
+      opt.parser = arg();
+    else if(flag == "-baseline")
+      opt.baseline = arg();
+    else if(flag == "-dir")
+      opt.workDir = arg();
+    else if(flag == "-repeat")
+      opt.numRepeat = std::stoi(arg());
+    else if(flag == "-time_tol")
+      opt.timeTol = std::stod(arg());
+    else if(flag == "-rss_tol")
+      opt.rssTol = std::stod(arg());
+    else if(flag == "-update")
+      opt.update = true;
+    else
+      usage();
+  }
+
+  if(opt.parser.empty() || opt.baseline.empty() || opt.workDir.empty() || opt.numRepeat < 1)
+    usage();
+
+  // The parser runs in the directory of each case
+  opt.parser = std::filesystem::absolute(opt.parser).string();
+
+  std::vector<PerfCase> cases = readBaseline(opt.baseline);
+  std::vector<PerfCase> results;
+
+  if(!opt.update)
+  {
+    printf("  %-10s %-14s %14s %14s %14s   %s\n",
+           "Case", "Metric", "Baseline", "Current", "Limit", "Status");
+    printf("  %s\n", std::string(84, '-').c_str());
+  }
+
+  int numFail = 0;
+
+  for(const PerfCase& base : cases)
+  {
+    PerfCase cur = runCase(opt, base);
+    results.push_back(cur);
+
+    if(opt.update)
+      printf("  %-10s %8.3f s %8.1f MB\n", cur.name.c_str(), cur.wallTime, cur.peakRss);
+    else if(!compare(opt, base, cur))
+      numFail++;
+
+    fflush(stdout);
+  }
+
+  if(opt.update)
+  {
+    writeBaseline(opt.baseline, results);
+    std::cout << "Baseline is updated : " << opt.baseline << std::endl;
+    return 0;
+  }
+
+  if(numFail > 0)
+  {
+    std::cout << numFail << " / " << cases.size() << " cases regressed." << std::endl;
+    return 1;
+  }
+
+  std::cout << "All " << cases.size() << " cases passed." << std::endl;
+  return 0;
+}
@@ -0,0 +1,32 @@
+#include "Profiler.h"
+
+#include <new>
+#include <cstdlib>
+
+// Replaces the global operator new / delete
+// so that every heap allocation of the process is counted by the Profiler.
+// Only linked into the executables : a program embedding the LefDefDB
+// library keeps its own allocator (numAllocs() is 0 then).
+
+void* operator new(std::size_t size)
+{
+  LefDefDB::Profiler::countAlloc();
+
+  if(size == 0)
+    size = 1;
+
+  if(void* ptr = std::malloc(size))
+    return ptr;
+
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete  (void* ptr) noexcept              { std::free(ptr); }
+void operator delete[](void* ptr) noexcept              { std::free(ptr); }
+void operator delete  (void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
@@ -0,0 +1,272 @@
+#include "BinGrid.h"
+#include "RTree.h"
+#include "Parallel.h"
+
+#include <algorithm>
+
+namespace LefDefDB
+{
+
+Status
+BinGrid::init(int numBinX, int numBinY)
+{
+  const dbDie* die = db_->die();
+
+  if(die->ux() <= die->lx() || die->uy() <= die->ly())
+    return Status::error("Die is empty. Please read .def first.");
+
+  if(numBinX < 1 || numBinY < 1)
+    return Status::error("Number of bins should be positive...");
+
+  numBinX_ = numBinX;
+  numBinY_ = numBinY;
+
+  lx_ = die->lx();
+  ly_ = die->ly();
+
+  binW_ = double(die->ux() - die->lx()) / double(numBinX_);
+  binH_ = double(die->uy() - die->ly()) / double(numBinY_);
+
+  values_.assign(numBinX_ * numBinY_, 0.0f);
+
+  return Status();
+}
+
+int
+BinGrid::binX(double dbX) const
+{
+  int x = static_cast<int>( (dbX - lx_) / binW_ );
+  return std::min(std::max(x, 0), numBinX_ - 1);
+}
+
+int
+BinGrid::binY(double dbY) const
+{
+  int y = static_cast<int>( (dbY - ly_) / binH_ );
+  return std::min(std::max(y, 0), numBinY_ - 1);
+}
+
+void
+BinGrid::addRect(std::vector<double>& grid,
+                 double lx, double ly, double ux, double uy, double weight) const
+{
+  lx = std::max(lx, double(lx_));
+  ly = std::max(ly, double(ly_));
+  ux = std::min(ux, lx_ + numBinX_ * binW_);
+  uy = std::min(uy, ly_ + numBinY_ * binH_);
+
+  if(ux <= lx || uy <= ly)
+    return;
+
+  int bx0 = binX(lx);
+  int by0 = binY(ly);
+  int bx1 = binX(ux);
+  int by1 = binY(uy);
+
+  // Overlap with the first / last column
+  double oxFirst = std::min(ux, lx_ + (bx0 + 1) * binW_) - lx;
+  double oxLast  = ux - (lx_ + bx1 * binW_);
+
+  const int stride = numBinX_ + 1;
+
+  // Row-wise difference: adding v to [b0, b1] is row[b0] += v, row[b1 + 1] -= v
+  // so a rectangle costs O(rows) instead of O(rows x columns)
+  for(int by = by0; by <= by1; by++)
+  {
+    double binLy = ly_ + by * binH_;
+    double oy    = std::min(uy, binLy + binH_) - std::max(ly, binLy);
+
+    if(oy <= 0.0)
+      continue;
+
+    double  wy  = weight * oy;
+    double* row = grid.data() + by * stride;
+
+    if(bx0 == bx1)
+    {
+      row[bx0]     += wy * (ux - lx);
+      row[bx0 + 1] -= wy * (ux - lx);
+      continue;
+    }
+
+    row[bx0]     += wy * oxFirst;
+    row[bx0 + 1] -= wy * oxFirst;
+
+    // Columns fully covered
+    row[bx0 + 1] += wy * binW_;
+    row[bx1]     -= wy * binW_;
+
+    row[bx1]     += wy * oxLast;
+    row[bx1 + 1] -= wy * oxLast;
+  }
+}
+
+void
+BinGrid::reduce(const std::vector<std::vector<double>>& grids, double scale,
+                const std::vector<float>* freeRatio)
+{
+  const int stride = numBinX_ + 1;
+  const int size   = numBinY_ * stride;
+
+  std::vector<double> total(grids[0]);
+
+  // No dependency between iterations (vectorizable)
+  for(int t = 1; t < grids.size(); t++)
+  {
+    const double* grid = grids[t].data();
+    for(int i = 0; i < size; i++)
+      total[i] += grid[i];
+  }
+
+  double sum = 0.0;
+  maxValue_  = 0.0f;
+
+  for(int by = 0; by < numBinY_; by++)
+  {
+    const double* row = total.data() + by * stride;
+
+    double prefix = 0.0;
+
+    for(int bx = 0; bx < numBinX_; bx++)
+    {
+      prefix += row[bx];
+
+      float value = static_cast<float>(std::max(prefix, 0.0) * scale);
+
+      // Bins (almost) covered by macros have no room
+      if(freeRatio != nullptr)
+      {
+        float ratio = (*freeRatio)[by * numBinX_ + bx];
+        value = ratio > 1e-3f ? value / ratio : 0.0f;
+      }
+
+      values_[by * numBinX_ + bx] = value;
+      maxValue_ = std::max(maxValue_, value);
+      sum      += value;
+    }
+  }
+
+  avgValue_ = static_cast<float>(sum / (numBinX_ * numBinY_));
+}
+
+Status
+BinGrid::computeDensity(int numBinX, int numBinY, const RTree* blocks)
+{
+  if(Status status = init(numBinX, numBinY); !status)
+    return status;
+
+  const std::vector<dbCell*>& cells = db_->cells();
+
+  int numCell    = cells.size();
+
+  // Free area of each bin (without the macros of the tree)
+  std::vector<float> freeRatio;
+  std::vector<char>  isBlock;
+
+  if(blocks != nullptr)
+  {
+    std::vector<std::vector<double>> blocked(1);
+    blocked[0].assign(numBinY_ * (numBinX_ + 1), 0.0);
+
+    isBlock.assign(numCell, false);
+
+    for(const RTree::Object& o : blocks->objects())
+    {
+      if(o.kind != RTree::Kind::Macro || o.id >= numCell)
+        continue;
+
+      addRect(blocked[0], o.lx, o.ly, o.ux, o.uy, 1.0);
+      isBlock[o.id] = true;
+    }
+
+    reduce(blocked, 1.0 / (binW_ * binH_));
+
+    freeRatio.resize(values_.size());
+
+    for(size_t i = 0; i < values_.size(); i++)
+      freeRatio[i] = std::max(0.0f, 1.0f - values_[i]);
+  }
+
+  int numThreads = std::max(1, std::min(db_->numThreads(), numCell));
+
+  // Per-thread grids (no atomic / lock in the inner loop)
+  std::vector<std::vector<double>> grids(numThreads);
+
+  runChunks(numThreads, numCell, [&] (int t, int begin, int end)
+  {
+    grids[t].assign(numBinY_ * (numBinX_ + 1), 0.0);
+
+    for(int i = begin; i < end; i++)
+    {
+      if(!isBlock.empty() && isBlock[i])
+        continue;
+
+      const dbCell* c = cells[i];
+      addRect(grids[t], c->lx(), c->ly(), c->ux(), c->uy(), 1.0);
+    }
+  });
+
+  reduce(grids, 1.0 / (binW_ * binH_), blocks != nullptr ? &freeRatio : nullptr);
+
+  return Status();
+}
+
+Status
+BinGrid::computeRudy(int numBinX, int numBinY)
+{
+  if(Status status = init(numBinX, numBinY); !status)
+    return status;
+
+  const std::vector<dbNet*>& nets = db_->nets();
+
+  int numNet     = nets.size();
+  int numThreads = std::max(1, std::min(db_->numThreads(), numNet));
+
+  std::vector<std::vector<double>> grids(numThreads);
+
+  runChunks(numThreads, numNet, [&] (int t, int begin, int end)
+  {
+    grids[t].assign(numBinY_ * (numBinX_ + 1), 0.0);
+
+    for(int i = begin; i < end; i++)
+    {
+      const dbNet* net = nets[i];
+
+      // Tie nets are not routed as signal nets
+      if(net->isTie() || net->pins().size() < 2)
+        continue;
+
+      int netLx = INT_MAX;
+      int netLy = INT_MAX;
+      int netUx = INT_MIN;
+      int netUy = INT_MIN;
+
+      for(const dbPin* pin : net->pins())
+      {
+        int x, y;
+        pinLocation(pin, x, y);
+
+        netLx = std::min(netLx, x);
+        netLy = std::min(netLy, y);
+        netUx = std::max(netUx, x);
+        netUy = std::max(netUy, y);
+      }
+
+      // Degenerated bounding box is expanded to one bin
+      double w  = std::max(double(netUx - netLx), binW_);
+      double h  = std::max(double(netUy - netLy), binH_);
+      double cx = 0.5 * (netLx + netUx);
+      double cy = 0.5 * (netLy + netUy);
+
+      // HPWL spread uniformly over the bounding box
+      addRect(grids[t], cx - 0.5 * w, cy - 0.5 * h,
+                        cx + 0.5 * w, cy + 0.5 * h, (w + h) / (w * h));
+    }
+  });
+
+  reduce(grids, double(db_->dbUnit()) / (binW_ * binH_));
+
+  return Status();
+}
+
+} // namespace LefDefDB
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "LefDefParser.h"
+
+namespace LefDefDB
+{
+
+class RTree;
+
+// Uniform bin grid over the die
+// for placement analysis (cell density, RUDY congestion)
+// Bin (x, y) is values()[y * numBinX() + x], (0, 0) is the lower-left bin.
+class BinGrid
+{
+  public:
+
+    BinGrid(std::shared_ptr<LefDefParser> db) : db_ (db) {}
+
+    Status computeDensity(int numBinX, int numBinY,         // Cell area / Bin area
+                          const RTree* blocks = nullptr);   // Macros of blocks are taken out of the bin area
+                                                            // (Cell area / Free area)
+    Status computeRudy   (int numBinX, int numBinY);        // Rectangular Uniform wire DensitY
+                                                            // (estimated wirelength (um) / bin area (um^2))
+    // Getters
+    int       numBinX() const { return numBinX_;  }
+    int       numBinY() const { return numBinY_;  }
+
+    int            lx() const { return lx_;       }
+    int            ly() const { return ly_;       }
+    double       binW() const { return binW_;     }          // dbu
+    double       binH() const { return binH_;     }          // dbu
+
+    float    maxValue() const { return maxValue_; }
+    float    avgValue() const { return avgValue_; }
+
+    float value(int binX, int binY) const { return values_[binY * numBinX_ + binX]; }
+
+    const std::vector<float>& values() const { return values_; }
+
+    // Bin index of the given dbu coordinate (clamped)
+    int binX(double dbX) const;
+    int binY(double dbY) const;
+
+  private:
+
+    std::shared_ptr<LefDefParser> db_;
+
+    int numBinX_  = 0;
+    int numBinY_  = 0;
+
+    int lx_       = 0;
+    int ly_       = 0;
+
+    double binW_  = 0.0;
+    double binH_  = 0.0;
+
+    float maxValue_ = 0.0f;
+    float avgValue_ = 0.0f;
+
+    std::vector<float> values_;
+
+    Status init(int numBinX, int numBinY);
+
+    // Add (weight x overlap area) of the rectangle to the bins it touches
+    // grid is a row-wise difference array (numBinY x (numBinX + 1))
+    void addRect(std::vector<double>& grid,
+                 double lx, double ly, double ux, double uy, double weight) const;
+
+    // Sum up the per-thread grids and take the prefix sum of each row
+    // (divided by freeRatio of each bin if it is given)
+    void reduce(const std::vector<std::vector<double>>& grids, double scale,
+                const std::vector<float>* freeRatio = nullptr);
+};
+
+} // namespace LefDefDB
@@ -0,0 +1,12 @@
+#pragma once
+
+// Forward declarations of CImg (extern/CImg/CImg.h)
+// CImg.h (and Xlib) is included only by the sources of Painter,
+// so it is not needed by the users of the installed headers.
+namespace cimg_library
+{
+
+template<typename T> struct CImg;
+struct CImgDisplay;
+
+} // namespace cimg_library
@@ -2,25 +2,58 @@
 #include <string>
 #include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <iomanip>
+#include <numeric>
 
 #include "CmdInterpreter.h"
+#include "Profiler.h"
+#include "Wirelength.h"
+
+// Thrown by the commands at the first error
+// (caught by readCmd, which stops the script)
+class CmdError : public std::runtime_error
+{
+  public:
+
+    CmdError(const std::string& message) : std::runtime_error(message) {}
+};
 
 inline void argumentError(const std::string& cmd)
 {
-  std::cout << "Please give argument to " << cmd << "\n";
-  exit(0);
+  throw CmdError("Please give argument to " + cmd);
 }
 
 inline void optionError(const std::string& opt, const std::string& cmd)
 {
-  std::cout << "Unknown option " << opt << "for " << cmd << "\n";
-  exit(0);
+  throw CmdError("Unknown option " + opt + " for " + cmd);
 }
 
 inline void typeError(const std::string& type)
 {
-  std::cout << "Please give ." << type << " file...\n";
-  exit(0);
+  throw CmdError("Please give ." + type + " file...");
+}
+
+// Failure of the Parser / Painter API
+inline void checkStatus(const Status& status)
+{
+  if(!status)
+    throw CmdError(status.message());
+}
+
+// "3840x2160" -> 3840, 2160
+inline void readDimension(const std::string& arg, const std::string& cmd, int& x, int& y)
+{
+  size_t pos = arg.find('x');
+
+  if(pos == std::string::npos)
+    argumentError(cmd + " (e.g. 3840x2160)");
+
+  x = std::stoi( arg.substr(0, pos) );
+  y = std::stoi( arg.substr(pos + 1) );
 }
 
 inline bool checkFileType(const std::filesystem::path& path, const std::string& type)
@@ -36,57 +69,162 @@ inline bool checkFileType(const std::filesystem::path& path, const std::string&
 }
 
 CmdInterpreter::CmdInterpreter()
-  : parser_   (nullptr),
-    painter_  (nullptr)
+  : out_      (&std::cout)
+  , headless_ (false)
+  , parser_   (nullptr)
+#ifdef PARSER_WITH_PAINTER
+  , painter_  (nullptr)
+#endif
 {}
 
-void
+Status
 CmdInterpreter::readCmd(const std::filesystem::path& cmdfile)
 {
-  if(parser_ == nullptr || painter_ == nullptr)
-  {
-    std::cout << "Submodule for CmdInterpreter is not set!" << std::endl;
-    exit(0);
-  }
-
-  std::cout << "Read " << cmdfile << std::endl;
+  *out_ << "Read " << cmdfile << std::endl;
 
   if( !checkFileType(cmdfile, "cmd") )
-    typeError("cmd");
+    return Status::error("Please give .cmd file...");
 
-  std::string filename = std::string(cmdfile);
- 
-  file_.open(cmdfile);
+  // Local stream (a script can source another script)
+  std::ifstream file(cmdfile);
 
-  bool quit = false;
+  if(!file.good())
+    return Status::error("Failed to open " + std::string(cmdfile));
 
-  while(!file_.eof() && !quit)
+  Status status;
+
+  // The rest of the script is skipped at the first error
+  // (data loaded by the previous commands is kept)
+  while(!file.eof() && status)
   {
-    line_.clear();
-    cmd_.clear();
-    opt_.clear();
-    arg_.clear();
+    std::string line;
+    std::getline(file, line);
 
-    std::getline(file_, line_);
+    status = runLine(line);
+  }
 
-    if(auto comment = line_.find('#'); comment != std::string::npos)
-      line_.erase(comment);
-    // If # is found, delete the rest of the line
+  return status;
+}
 
-    if(line_.empty()) 
-      continue;
+Status
+CmdInterpreter::readBatch(const std::vector<std::filesystem::path>& cmdfiles)
+{
+  // DEF of each script is unloaded after the script,
+  // unless the DEF was loaded before the batch (then the scripts cannot read_def)
+  const bool hasBaseDef = parser_->isDefLoaded();
 
-    ss_ = std::stringstream(line_);
-    ss_ >> cmd_;
+  int numFail = 0;
 
-    if(auto findCmd = cmdList_.find(cmd_); findCmd != cmdList_.end())
-      (this->*(findCmd->second))();
-    else
+  for(const auto& cmdfile : cmdfiles)
+  {
+    if(Status status = readCmd(cmdfile); !status)
     {
-      std::cout << "Undefined Command: " << cmd_ << std::endl;
-      quit = true;
+      *out_ << status.message() << std::endl;
+      numFail++;
     }
+
+    if(!hasBaseDef && parser_->isDefLoaded())
+      (void)parser_->unloadDef();
   }
+
+  if(numFail > 0)
+    return Status::error(std::to_string(numFail) + " / " + std::to_string(cmdfiles.size()) 
+                         + " scripts failed.");
+
+  return Status();
+}
+
+Status
+CmdInterpreter::runShell(std::istream& in)
+{
+  // Errors are printed and the shell goes on
+  std::string line;
+
+  while(true)
+  {
+    *out_ << "Parser> " << std::flush;
+
+    if(!std::getline(in, line))
+      break;
+
+    std::string word;
+    std::stringstream(line) >> word;
+
+    if(word == "exit" || word == "quit")
+      break;
+
+    if(Status status = runLine(line); !status)
+      *out_ << status.message() << std::endl;
+  }
+
+  *out_ << std::endl;
+
+  return Status();
+}
+
+Status
+CmdInterpreter::runLine(const std::string& line)
+{
+#ifdef PARSER_WITH_PAINTER
+  if(parser_ == nullptr || painter_ == nullptr)
+#else
+  if(parser_ == nullptr)
+#endif
+    return Status::error("Submodule for CmdInterpreter is not set!");
+
+  line_ = line;
+  cmd_.clear();
+  opt_.clear();
+  arg_.clear();
+
+  if(auto comment = line_.find('#'); comment != std::string::npos)
+    line_.erase(comment);
+  // If # is found, delete the rest of the line
+
+  ss_ = std::stringstream(line_);
+  ss_ >> cmd_;
+
+  if(cmd_.empty()) 
+    return Status();
+
+  auto findCmd = cmdList_.find(cmd_);
+
+  if(findCmd == cmdList_.end())
+    return Status::error("Undefined Command: " + cmd_);
+
+  try
+  {
+    ProfileScope scope(cmd_);
+    (this->*(findCmd->second))();
+  }
+  catch(const CmdError& e)
+  {
+    return Status::error(e.what());
+  }
+  catch(const std::invalid_argument& e)                     // std::stoi
+  {
+    return Status::error("Invalid number in " + cmd_ + " : " + line_);
+  }
+  catch(const std::out_of_range& e)
+  {
+    return Status::error("Number out of range in " + cmd_ + " : " + line_);
+  }
+  catch(const std::filesystem::filesystem_error& e)         // -dir
+  {
+    return Status::error(e.what());
+  }
+
+  return Status();
+}
+
+bool
+CmdInterpreter::isReadOnly(const std::string& line)
+{
+  std::string cmd;
+  std::stringstream(line) >> cmd;
+
+  // Commands which only read the DB (and print to the output stream)
+  return cmd == "print_info" || cmd == "report_profile" || cmd == "report_hpwl";
 }
 
 void
@@ -102,7 +240,7 @@ CmdInterpreter::readLefCmd()
     {
       if( !checkFileType(file.path(), "lef") )
         continue;
-      parser_->readLef( file.path() );
+      checkStatus( parser_->readLef( file.path() ) );
     }
   }
   else
@@ -114,7 +252,7 @@ CmdInterpreter::readLefCmd()
     else if(arg_[0] == '-')
       optionError(opt_, cmd_);
     else
-      parser_->readLef(arg_);
+      checkStatus( parser_->readLef(arg_) );
   }
 }
 
@@ -126,28 +264,483 @@ CmdInterpreter::readDefCmd()
   if(arg_.empty())
     argumentError(cmd_);
   else
-    parser_->readDef(arg_);
+    checkStatus( parser_->readDef(arg_) );
 }
 
 void
 CmdInterpreter::readVerilogCmd()
 {
-  ss_ >> arg_;
+  ss_ >> opt_;
+
+  bool perCellTie = false;
+
+  // read_verilog -per_cell_tie xx.v
+  // 1'b0 / 1'b1 of each instance will be connected to its own tie stub
+  if(opt_ == "-per_cell_tie")
+  {
+    perCellTie = true;
+    ss_ >> arg_;
+  }
+  else
+    arg_ = opt_;
 
   if(arg_.empty())
     argumentError(cmd_);
+  else if(arg_[0] == '-')
+    optionError(arg_, cmd_);
   else
-    parser_->readVerilog(arg_);
+    checkStatus( parser_->readVerilog(arg_, perCellTie) );
+}
+
+void
+CmdInterpreter::unloadDefCmd()
+{
+  checkStatus( parser_->unloadDef() );
+}
+
+void
+CmdInterpreter::sourceCmd()
+{
+  ss_ >> arg_;
+
+  if(arg_.empty())
+    argumentError(cmd_);
+
+  std::filesystem::path cmdfile = arg_;
+
+  checkStatus( readCmd(cmdfile) );
 }
 
 void
 CmdInterpreter::printInfoCmd()
 {
-  parser_->printInfo();
+  parser_->printInfo(*out_);
+}
+
+void
+CmdInterpreter::setNumThreadsCmd()
+{
+  ss_ >> arg_;
+
+  if(arg_.empty())
+    argumentError(cmd_);
+
+  int numThreads = std::stoi(arg_);
+
+  if(numThreads < 1)
+    throw CmdError("Number of threads should be positive...");
+
+  parser_->setNumThreads(numThreads);
+}
+
+void
+CmdInterpreter::reportProfileCmd()
+{
+  // report_profile                -> Table of every command so far
+  // report_profile -json xx.json  -> Same in JSON (for regression tracking)
+  std::string fileName;
+
+  while(ss_ >> opt_)
+  {
+    if(opt_ == "-json")
+    {
+      ss_ >> fileName;
+
+      if(fileName.empty())
+        argumentError(cmd_ + " -json");
+    }
+    else
+      optionError(opt_, cmd_);
+  }
+
+  if(fileName.empty())
+    Profiler::printTable(*out_);
+  else if(Profiler::writeJson(fileName))
+    *out_ << "Write " << fileName << std::endl;
+  else
+    *out_ << "Failed to write " << fileName << std::endl;
+}
+
+void
+CmdInterpreter::reportHpwlCmd()
+{
+  // report_hpwl [-max_fanout 0] [-exclude xx -exclude yy ...] [-weight xx.txt] [-top 10]
+  // -max_fanout : Nets with more pins are excluded (0 : no limit)
+  // -weight     : Lines of "<net name> <weight>"
+  Wirelength wl(parser_);
+
+  int numTop = 10;
+
+  auto findNet = [&] (const std::string& netName)
+  {
+    int netID = parser_->findNetID(netName);
+
+    if(netID < 0)
+      throw CmdError("Net " + netName + " is not found in " + cmd_);
+
+    return netID;
+  };
+
+  while(ss_ >> opt_)
+  {
+    arg_.clear();
+
+    if(opt_ == "-max_fanout" || opt_ == "-exclude" || opt_ == "-weight" || opt_ == "-top")
+    {
+      ss_ >> arg_;
+
+      if(arg_.empty())
+        argumentError(cmd_ + " " + opt_);
+    }
+
+    if(opt_ == "-max_fanout")
+      wl.setMaxFanout( std::stoi(arg_) );
+    else if(opt_ == "-exclude")
+      wl.excludeNet( findNet(arg_) );
+    else if(opt_ == "-top")
+      numTop = std::stoi(arg_);
+    else if(opt_ == "-weight")
+    {
+      std::ifstream weightFile(arg_);
+
+      if(!weightFile.good())
+        throw CmdError("Failed to open " + arg_);
+
+      std::string netName;
+      double weight;
+
+      while(weightFile >> netName >> weight)
+        wl.setNetWeight(findNet(netName), weight);
+    }
+    else
+      optionError(opt_, cmd_);
+  }
+
+  auto t1 = std::chrono::steady_clock::now();
+
+  checkStatus( wl.computeHpwl() );
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+
+  const std::vector<dbNet*>& nets = parser_->nets();
+
+  const double dbUnit = parser_->dbUnit();
+
+  // Stream state is restored at the end (out_ can be shared)
+  std::ios_base::fmtflags flags = out_->flags();
+  std::streamsize precision     = out_->precision();
+
+  *out_ << std::fixed << std::setprecision(3);
+  *out_ << "HPWL : " << wl.totalHpwl() / dbUnit << " um";
+  *out_ << " (" << wl.numNetCounted() << " nets, " << wl.numNetExcluded() << " excluded) ";
+  *out_ << "in " << std::setprecision(4) << runtime.count() << " s" << std::endl;
+
+  // Longest nets
+  std::vector<int> order(nets.size());
+  std::iota(order.begin(), order.end(), 0);
+
+  numTop = std::max(0, std::min(numTop, static_cast<int>(order.size())));
+
+  std::partial_sort(order.begin(), order.begin() + numTop, order.end(),
+                    [&] (int a, int b) { return wl.netHpwl(a) > wl.netHpwl(b)
+                                            || (wl.netHpwl(a) == wl.netHpwl(b) && a < b); });
+
+  for(int i = 0; i < numTop && wl.netHpwl(order[i]) > 0; i++)
+  {
+    const dbNet* net = nets[order[i]];
+
+    *out_ << "  " << std::left << std::setw(24) << net->name() << std::right
+          << std::setw(16) << std::setprecision(3) << wl.netHpwl(order[i]) / dbUnit << " um"
+          << std::setw(8)  << net->pins().size() << " pins" << std::endl;
+  }
+
+  out_->flags(flags);
+  out_->precision(precision);
+}
+
+#ifdef PARSER_WITH_PAINTER
+
+void
+CmdInterpreter::checkHeadless(const std::string& fileName)
+{
+  // The window would block the other clients of the server until it is closed
+  if(headless_ && fileName.empty())
+    throw CmdError("Please give -o to " + cmd_ + " (no window in server sessions)");
 }
 
 void
 CmdInterpreter::drawChipCmd()
 {
-  painter_->drawChip();
+  // draw_chip                              -> Interactive Mode
+  // draw_chip -o xx.png [-size 4096x4096]  -> Headless Mode
+  // draw_chip -bench    [-size 4096x4096]  -> Frame time for 1 ~ 32 threads
+  std::string fileName;
+
+  bool bench = false;
+
+  int width  = 4096;
+  int height = 4096;
+
+  while(ss_ >> opt_)
+  {
+    if(opt_ == "-o")
+    {
+      ss_ >> fileName;
+
+      if(fileName.empty())
+        argumentError(cmd_ + " -o");
+    }
+    else if(opt_ == "-bench")
+      bench = true;
+    else if(opt_ == "-size")
+    {
+      ss_ >> arg_;
+      readDimension(arg_, cmd_ + " -size", width, height);
+    }
+    else
+      optionError(opt_, cmd_);
+  }
+
+  if(!bench)
+    checkHeadless(fileName);
+
+  if(bench)
+    painter_->benchDrawChip(width, height);
+  else if(fileName.empty())
+    painter_->drawChip();
+  else
+    painter_->drawChip(fileName, width, height);
 }
+
+void
+CmdInterpreter::drawHeatmapCmd()
+{
+  // draw_density [-grid 64x64] [-o xx.png] [-size 4096x4096] [-macro_aware]
+  // draw_rudy    [-grid 64x64] [-o xx.png] [-size 4096x4096]
+  std::string fileName;
+
+  bool macroAware = false;
+
+  int width   = 4096;
+  int height  = 4096;
+
+  int numBinX = 64;
+  int numBinY = 64;
+
+  while(ss_ >> opt_)
+  {
+    if(opt_ == "-o")
+    {
+      ss_ >> fileName;
+
+      if(fileName.empty())
+        argumentError(cmd_ + " -o");
+    }
+    else if(opt_ == "-size")
+    {
+      ss_ >> arg_;
+      readDimension(arg_, cmd_ + " -size", width, height);
+    }
+    else if(opt_ == "-grid")
+    {
+      ss_ >> arg_;
+      readDimension(arg_, cmd_ + " -grid", numBinX, numBinY);
+    }
+    else if(opt_ == "-macro_aware" && cmd_ == "draw_density")
+      macroAware = true;
+    else
+      optionError(opt_, cmd_);
+  }
+
+  checkHeadless(fileName);
+
+  if(cmd_ == "draw_density")
+    checkStatus( painter_->drawDensity(fileName, width, height, numBinX, numBinY, macroAware) );
+  else
+    checkStatus( painter_->drawRudy(fileName, width, height, numBinX, numBinY) );
+}
+
+void
+CmdInterpreter::drawNetsCmd()
+{
+  // draw_nets [-max_fanout 50] [-bbox] [-net xx -net yy ...] [-o xx.png] [-size 4096x4096]
+  std::string fileName;
+  std::vector<std::string> netNames;
+
+  int width     = 4096;
+  int height    = 4096;
+  int maxFanout = 50;
+
+  bool drawBBox = false;
+
+  while(ss_ >> opt_)
+  {
+    if(opt_ == "-o")
+    {
+      ss_ >> fileName;
+
+      if(fileName.empty())
+        argumentError(cmd_ + " -o");
+    }
+    else if(opt_ == "-size")
+    {
+      ss_ >> arg_;
+      readDimension(arg_, cmd_ + " -size", width, height);
+    }
+    else if(opt_ == "-max_fanout")
+    {
+      arg_.clear();
+      ss_ >> arg_;
+
+      if(arg_.empty())
+        argumentError(cmd_ + " -max_fanout");
+
+      maxFanout = std::stoi(arg_);
+
+      if(maxFanout < 0)
+        throw CmdError("Max fanout of " + cmd_ + " should not be negative...");
+    }
+    else if(opt_ == "-net")
+    {
+      arg_.clear();
+      ss_ >> arg_;
+
+      if(arg_.empty())
+        argumentError(cmd_ + " -net");
+
+      netNames.push_back(arg_);
+    }
+    else if(opt_ == "-bbox")
+      drawBBox = true;
+    else
+      optionError(opt_, cmd_);
+  }
+
+  checkHeadless(fileName);
+
+  painter_->drawNets(fileName, width, height, maxFanout, drawBBox, netNames);
+}
+
+// "step2.def" < "step10.def" (digits are compared as numbers)
+inline bool naturalLess(const std::string& a, const std::string& b)
+{
+  auto isdigit = [] (char c) { return c >= '0' && c <= '9'; };
+
+  size_t i = 0;
+  size_t j = 0;
+
+  while(i < a.size() && j < b.size())
+  {
+    if(isdigit(a[i]) && isdigit(b[j]))
+    {
+      size_t ie = i;
+      size_t je = j;
+
+      while(ie < a.size() && isdigit(a[ie])) ie++;
+      while(je < b.size() && isdigit(b[je])) je++;
+
+      unsigned long long na = std::stoull( a.substr(i, ie - i) );
+      unsigned long long nb = std::stoull( b.substr(j, je - j) );
+
+      if(na != nb)
+        return na < nb;
+
+      i = ie;
+      j = je;
+    }
+    else
+    {
+      if(a[i] != b[j])
+        return a[i] < b[j];
+
+      i++;
+      j++;
+    }
+  }
+
+  return a.size() - i < b.size() - j;
+}
+
+void
+CmdInterpreter::drawTrajectoryCmd()
+{
+  // draw_trajectory <def_dir> [-o xx.png] [-gif xx.gif] [-delay 10] [-size 1024x1024]
+  // -o   : numbered images (xx_0000.png, xx_0001.png, ...)
+  // -gif : animated GIF (delay in 1/100 s)
+  std::string defDir;
+  std::string seqName;
+  std::string gifName;
+
+  int width  = 1024;
+  int height = 1024;
+  int delay  = 10;
+
+  while(ss_ >> opt_)
+  {
+    if(opt_ == "-o")
+    {
+      ss_ >> seqName;
+
+      if(seqName.empty())
+        argumentError(cmd_ + " -o");
+    }
+    else if(opt_ == "-gif")
+    {
+      ss_ >> gifName;
+
+      if(gifName.empty())
+        argumentError(cmd_ + " -gif");
+    }
+    else if(opt_ == "-delay")
+    {
+      arg_.clear();
+      ss_ >> arg_;
+
+      if(arg_.empty())
+        argumentError(cmd_ + " -delay");
+
+      delay = std::stoi(arg_);
+    }
+    else if(opt_ == "-size")
+    {
+      ss_ >> arg_;
+      readDimension(arg_, cmd_ + " -size", width, height);
+    }
+    else if(opt_[0] == '-')
+      optionError(opt_, cmd_);
+    else
+      defDir = opt_;
+  }
+
+  if(defDir.empty())
+    argumentError(cmd_);
+
+  if(seqName.empty() && gifName.empty())
+    throw CmdError("Please give -o or -gif to " + cmd_);
+
+  // GIF89a stores the size in 16 bits
+  if(!gifName.empty() && (width > 65535 || height > 65535))
+    throw CmdError("Size of GIF should be smaller than 65536x65536...");
+
+  if(!std::filesystem::is_directory(defDir))
+    throw CmdError(defDir + " is not a directory...");
+
+  std::vector<std::string> defFiles;
+
+  for(auto& file : dirItr(defDir) )
+  {
+    if( checkFileType(file.path(), "def") )
+      defFiles.push_back( std::string(file.path()) );
+  }
+
+  // Frame order follows the file names (step2.def before step10.def)
+  std::sort(defFiles.begin(), defFiles.end(), naturalLess);
+
+  *out_ << "Read " << defFiles.size() << " DEFs in " << defDir << std::endl;
+
+  painter_->drawTrajectory(defFiles, seqName, gifName, width, height, delay);
+}
+
+#endif // PARSER_WITH_PAINTER
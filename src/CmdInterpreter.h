@@ -3,13 +3,20 @@
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <vector>
+#include <fstream>
+#include <sstream>
 #include <filesystem>
 
 #include "LefDefParser.h"
+
+// The draw_* commands need the Painter library (CMake option PARSER_WITH_PAINTER)
+#ifdef PARSER_WITH_PAINTER
 #include "Painter.h"
+using namespace Graphic;
+#endif
 
 using namespace LefDefDB;
-using namespace Graphic;
 
 typedef std::filesystem::directory_iterator dirItr;
 
@@ -21,18 +28,33 @@ class CmdInterpreter
 
     // Setters
     void setParser   (std::shared_ptr<LefDefParser> parser )  { parser_   = parser;   }
+#ifdef PARSER_WITH_PAINTER
     void setPainter  (std::shared_ptr<Painter>      painter)  { painter_  = painter;  }
+#endif
+    void setOutput   (std::ostream& out)                      { out_      = &out;     } // std::cout by default
+    void setHeadless (bool headless)                          { headless_ = headless; } // Reject the draw modes with a window
+                                                                                        // (server sessions)
 
     // For main functionality
-    void readCmd(const std::filesystem::path& cmdfile);     // Read Command (.cmd) file
+    Status readCmd(const std::filesystem::path& cmdfile);   // Read Command (.cmd) file
+                                                            // (stops at the first failed command)
+    Status readBatch(const std::vector<std::filesystem::path>& cmdfiles); // Run each script on the current DB
+                                                                          // (DEF is unloaded after each script)
+    Status runShell(std::istream& in);                      // Interactive shell (until exit / quit / EOF)
+    Status runLine(const std::string& line);                // Run one line of .cmd
+
+    static bool isReadOnly(const std::string& line);        // true if the command does not modify the DB
 
   private:
 
+    std::ostream*                 out_;                     // Output of the commands (not of the Parser / Painter)
+    bool                          headless_;                // No interactive window (draw_* needs -o)
     std::shared_ptr<LefDefParser> parser_;                  // SharedPointer of Parser
+#ifdef PARSER_WITH_PAINTER
     std::shared_ptr<Painter>      painter_;                 // SharedPointer of Painter
+#endif
 
     // For parsing .cmd file
-    std::ifstream         file_;                            // Input File Stream
     std::stringstream       ss_;                            // String Stream
     std::string           line_;                            // Buffer for line
     std::string            cmd_;                            // Buffer for command
@@ -42,9 +64,20 @@ class CmdInterpreter
     void readLefCmd          ();                            // Wrapper for read_lef     in LefDefParser
     void readDefCmd          ();                            // Wrapper for read_def     in LefDefParser
     void readVerilogCmd      ();                            // Wrapper for read_verilog in LefDefParser
+    void unloadDefCmd        ();                            // Wrapper for unloadDef    in LefDefParser
     void printInfoCmd        ();                            // Wrapper for printInfo    in LefDefParser
-    
+    void setNumThreadsCmd    ();                            // Wrapper for setNumThreads in LefDefParser
+    void reportProfileCmd    ();                            // Print (or dump) the timers of commands
+    void reportHpwlCmd       ();                            // Wrapper for computeHpwl  in Wirelength
+    void sourceCmd           ();                            // Run another .cmd file
+
+#ifdef PARSER_WITH_PAINTER
     void drawChipCmd         ();                            // Wrapper for drawChip     in Painter 
+    void drawHeatmapCmd      ();                            // Wrapper for drawDensity / drawRudy in Painter
+    void drawNetsCmd         ();                            // Wrapper for drawNets     in Painter
+    void drawTrajectoryCmd   ();                            // Wrapper for drawTrajectory in Painter
+    void checkHeadless       (const std::string& fileName); // Error if a window would be opened in headless mode
+#endif
 
     // Table: [CMD String] [Function Pointer]
     // Inspired by OpenTimer...
@@ -53,7 +86,18 @@ class CmdInterpreter
       {"read_lef"    ,   &CmdInterpreter::readLefCmd     },
       {"read_def"    ,   &CmdInterpreter::readDefCmd     },
       {"read_verilog",   &CmdInterpreter::readVerilogCmd },
+      {"unload_def"  ,   &CmdInterpreter::unloadDefCmd   },
       {"print_info"  ,   &CmdInterpreter::printInfoCmd   },
-      {"draw_chip"   ,   &CmdInterpreter::drawChipCmd    }
+      {"set_num_threads", &CmdInterpreter::setNumThreadsCmd },
+      {"report_profile",  &CmdInterpreter::reportProfileCmd },
+      {"report_hpwl" ,   &CmdInterpreter::reportHpwlCmd  },
+      {"source"      ,   &CmdInterpreter::sourceCmd      },
+#ifdef PARSER_WITH_PAINTER
+      {"draw_chip"   ,   &CmdInterpreter::drawChipCmd    },
+      {"draw_density",   &CmdInterpreter::drawHeatmapCmd },
+      {"draw_rudy"   ,   &CmdInterpreter::drawHeatmapCmd },
+      {"draw_nets"   ,   &CmdInterpreter::drawNetsCmd    },
+      {"draw_trajectory", &CmdInterpreter::drawTrajectoryCmd }
+#endif
     };
 };
@@ -0,0 +1,242 @@
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <sstream>
+#include <iostream>
+
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include "CmdServer.h"
+
+// Send the whole buffer (false if the client is gone)
+inline bool sendAll(int fd, const std::string& buffer)
+{
+  size_t sent = 0;
+
+  while(sent < buffer.size())
+  {
+    ssize_t size = send(fd, buffer.data() + sent, buffer.size() - sent, MSG_NOSIGNAL);
+
+    if(size <= 0)
+      return false;
+
+    sent += size;
+  }
+
+  return true;
+}
+
+CmdServer::CmdServer(std::shared_ptr<LefDefParser> parser)
+  : parser_    (parser)
+#ifdef PARSER_WITH_PAINTER
+  , painter_   (nullptr)
+#endif
+  , isStopped_ (false)
+  , listenFd_  (-1)
+{}
+
+Status
+CmdServer::serve(const std::string& socketPath)
+{
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+
+  if(socketPath.size() >= sizeof(addr.sun_path))
+    return Status::error("Socket path is too long : " + socketPath);
+
+  std::strcpy(addr.sun_path, socketPath.c_str());
+
+  // Socket file of the previous run (any other file is kept)
+  if(struct stat st; lstat(socketPath.c_str(), &st) == 0)
+  {
+    if(!S_ISSOCK(st.st_mode))
+      return Status::error(socketPath + " already exists and is not a socket");
+
+    unlink(socketPath.c_str());
+  }
+
+  listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  if(listenFd_ < 0)
+    return Status::error("Failed to make a socket");
+
+  if(bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+  || listen(listenFd_, SOMAXCONN) != 0)
+  {
+    close(listenFd_);
+    return Status::error("Failed to listen on " + socketPath + " : " + std::strerror(errno));
+  }
+
+  std::cout << "Serve on " << socketPath << std::endl;
+
+  while(!isStopped_)
+  {
+    int fd = accept(listenFd_, nullptr, nullptr);
+
+    if(fd < 0)
+    {
+      if(errno == EINTR)
+        continue;
+      break;                                                // shutdown() of listenFd_
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(sessionMutex_);
+
+      if(isStopped_)
+      {
+        close(fd);
+        break;
+      }
+
+      sessionFds_.insert(fd);
+    }
+
+    // Detached : a finished session leaves nothing behind
+    std::thread(&CmdServer::session, this, fd).detach();
+  }
+
+  // Wait for the open sessions (woken up by "shutdown")
+  {
+    std::unique_lock<std::mutex> lock(sessionMutex_);
+    sessionDone_.wait(lock, [this] () { return sessionFds_.empty(); });
+  }
+
+  close(listenFd_);
+  unlink(socketPath.c_str());
+
+  std::cout << "Server is stopped." << std::endl;
+
+  return Status();
+}
+
+void
+CmdServer::session(int fd)
+{
+  sessionLoop(fd);
+
+  // serve() may return as soon as the last session is erased
+  {
+    std::lock_guard<std::mutex> lock(sessionMutex_);
+    sessionFds_.erase(fd);
+    sessionDone_.notify_all();
+  }
+
+  close(fd);
+}
+
+void
+CmdServer::sessionLoop(int fd)
+{
+  CmdInterpreter cmd;
+  cmd.setParser(parser_);
+  cmd.setHeadless(true);
+#ifdef PARSER_WITH_PAINTER
+  cmd.setPainter(painter_);
+#endif
+
+  std::string buffer;
+  char chunk[4096];
+
+  bool quit = false;
+
+  while(!quit)
+  {
+    ssize_t size = recv(fd, chunk, sizeof(chunk), 0);
+
+    if(size <= 0)
+      break;
+
+    buffer.append(chunk, size);
+
+    size_t begin = 0;
+
+    for(size_t end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n', begin))
+    {
+      std::string line = buffer.substr(begin, end - begin);
+      begin = end + 1;
+
+      if(!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+      std::string word;
+      std::stringstream(line) >> word;
+
+      if(word == "quit")
+      {
+        quit = true;
+        break;
+      }
+
+      if(word == "shutdown")
+      {
+        sendAll(fd, "%OK\n");
+
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+
+        // Wake up accept() and recv() of the other sessions
+        isStopped_ = true;
+        shutdown(listenFd_, SHUT_RDWR);
+
+        for(int other : sessionFds_)
+          shutdown(other, SHUT_RDWR);
+
+        quit = true;
+        break;
+      }
+
+      std::string out;
+      Status status = runLine(cmd, line, out);
+
+      if(!out.empty() && out.back() != '\n')
+        out.push_back('\n');
+
+      if(status)
+        out += "%OK\n";
+      else
+        out += "%ERROR " + status.message() + "\n";
+
+      if(!sendAll(fd, out))
+      {
+        quit = true;
+        break;
+      }
+    }
+
+    buffer.erase(0, begin);
+  }
+}
+
+Status
+CmdServer::runLine(CmdInterpreter& cmd, const std::string& line, std::string& out)
+{
+  std::ostringstream oss;
+  cmd.setOutput(oss);
+
+  Status status;
+
+  if(CmdInterpreter::isReadOnly(line))
+  {
+    std::shared_lock<std::shared_mutex> lock(dbMutex_);
+    status = cmd.runLine(line);
+  }
+  else
+  {
+    std::unique_lock<std::shared_mutex> lock(dbMutex_);
+
+    // No other command is running (readers only write to their own stream)
+    std::streambuf* buf = std::cout.rdbuf(oss.rdbuf());
+    status = cmd.runLine(line);
+    std::cout.rdbuf(buf);
+  }
+
+  cmd.setOutput(std::cout);
+
+  out = oss.str();
+
+  return status;
+}
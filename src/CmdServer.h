@@ -0,0 +1,57 @@
+#pragma once
+
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <shared_mutex>
+#include <condition_variable>
+
+#include "CmdInterpreter.h"
+
+// Resident DB server (Parser --serve <socket>)
+// Keeps the DB in memory and runs the .cmd commands sent over a Unix domain socket.
+//
+// Protocol (line-based, one command per line)
+//   client : print_info\n
+//   server : <output of the command> %OK\n   or   <output> %ERROR <message>\n
+//   "quit" closes the connection, "shutdown" stops the server.
+//
+// Read-only commands (CmdInterpreter::isReadOnly) run concurrently under a shared lock.
+// The others hold the lock exclusively, and std::cout is sent to the client meanwhile
+// (so the messages of read_def etc. are returned as the output).
+class CmdServer
+{
+  public:
+
+    CmdServer(std::shared_ptr<LefDefParser> parser);        // Constructor
+
+#ifdef PARSER_WITH_PAINTER
+    void setPainter(std::shared_ptr<Painter> painter) { painter_ = painter; }
+#endif
+
+    Status serve(const std::string& socketPath);            // Blocks until "shutdown"
+
+  private:
+
+    std::shared_ptr<LefDefParser> parser_;                  // SharedPointer of Parser
+#ifdef PARSER_WITH_PAINTER
+    std::shared_ptr<Painter>      painter_;                 // SharedPointer of Painter
+#endif
+
+    std::shared_mutex dbMutex_;                             // Shared : read-only commands
+                                                            // Unique : the others
+    std::atomic<bool> isStopped_;
+    int               listenFd_;
+
+    std::mutex        sessionMutex_;
+    std::set<int>     sessionFds_;                          // Open connections (closed at shutdown)
+    std::condition_variable sessionDone_;                   // A session is finished
+
+    void session    (int fd);                               // One client (on its own detached thread)
+    void sessionLoop(int fd);                               // Commands of the client until quit / shutdown
+
+    // Run one line with the lock of its kind (output is appended to out)
+    Status runLine(CmdInterpreter& cmd, const std::string& line, std::string& out);
+};
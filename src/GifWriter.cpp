@@ -0,0 +1,229 @@
+#include "GifWriter.h"
+#include "CImg.h"
+
+#include <cstdio>
+#include <cstdint>
+
+// LZW of GIF (8-bit pixels)
+#define GIF_MIN_CODE_SIZE     8
+#define GIF_MAX_CODE       4095
+#define GIF_HASH_SIZE      8192   // > GIF_MAX_CODE (load factor < 0.5)
+
+namespace Graphic
+{
+
+// Level (0 ~ 5) of the web-safe palette
+static inline int paletteLevel(unsigned char value)
+{
+  return (value * 5 + 127) / 255;
+}
+
+// Variable-length codes packed LSB first
+// into data sub-blocks of at most 255 bytes
+class LzwOutput
+{
+  public:
+
+    LzwOutput(std::vector<unsigned char>& out)
+      : out_ (out), bitBuf_ (0), numBits_ (0) {}
+
+    void put(int code, int codeSize)
+    {
+      bitBuf_  |= static_cast<uint32_t>(code) << numBits_;
+      numBits_ += codeSize;
+
+      while(numBits_ >= 8)
+      {
+        putByte(bitBuf_ & 0xFF);
+        bitBuf_  >>= 8;
+        numBits_  -= 8;
+      }
+    }
+
+    void flush()
+    {
+      if(numBits_ > 0)
+        putByte(bitBuf_ & 0xFF);
+
+      if(!block_.empty())
+        writeBlock();
+
+      out_.push_back(0); // Block Terminator
+    }
+
+  private:
+
+    std::vector<unsigned char>& out_;
+    std::vector<unsigned char>  block_;
+
+    uint32_t bitBuf_;
+    int      numBits_;
+
+    void putByte(unsigned char byte)
+    {
+      block_.push_back(byte);
+      if(block_.size() == 255)
+        writeBlock();
+    }
+
+    void writeBlock()
+    {
+      out_.push_back( static_cast<unsigned char>(block_.size()) );
+      out_.insert(out_.end(), block_.begin(), block_.end());
+      block_.clear();
+    }
+};
+
+std::vector<unsigned char>
+GifWriter::encodeFrame(const cimg_library::CImg<unsigned char>& img) const
+{
+  std::vector<unsigned char> out;
+
+  // Graphic Control Extension (delay)
+  out.insert(out.end(), { 0x21, 0xF9, 0x04, 0x00,
+                          static_cast<unsigned char>(delay_ & 0xFF),
+                          static_cast<unsigned char>(delay_ >> 8),
+                          0x00, 0x00 } );
+
+  // Image Descriptor (full frame, global color table)
+  out.insert(out.end(), { 0x2C, 0x00, 0x00, 0x00, 0x00,
+                          static_cast<unsigned char>(width_  & 0xFF),
+                          static_cast<unsigned char>(width_  >> 8),
+                          static_cast<unsigned char>(height_ & 0xFF),
+                          static_cast<unsigned char>(height_ >> 8),
+                          0x00 } );
+
+  out.push_back(GIF_MIN_CODE_SIZE);
+
+  // Pixel -> Palette index (row-major, top to bottom)
+  const int numPixel = width_ * height_;
+
+  const unsigned char* r = img.data(0, 0, 0, 0);
+  const unsigned char* g = img.data(0, 0, 0, img.spectrum() > 2 ? 1 : 0);
+  const unsigned char* b = img.data(0, 0, 0, img.spectrum() > 2 ? 2 : 0);
+
+  std::vector<unsigned char> index(numPixel);
+
+  for(int i = 0; i < numPixel; i++)
+    index[i] = paletteLevel(r[i]) * 36 + paletteLevel(g[i]) * 6 + paletteLevel(b[i]);
+
+  // LZW
+  const int clearCode = 1 << GIF_MIN_CODE_SIZE;
+  const int eoiCode   = clearCode + 1;
+
+  // Key : (prefix code << 8) | pixel
+  std::vector<int>     hashKey(GIF_HASH_SIZE, -1);
+  std::vector<int16_t> hashCode(GIF_HASH_SIZE);
+
+  int codeSize = GIF_MIN_CODE_SIZE + 1;
+  int nextCode = eoiCode + 1;
+  int maxCode  = 1 << codeSize;
+
+  LzwOutput lzw(out);
+
+  // Code size grows when the decoder's table reaches the current limit
+  auto emit = [&] (int code)
+  {
+    lzw.put(code, codeSize);
+
+    if(nextCode >= maxCode && code <= GIF_MAX_CODE && codeSize < 12)
+      maxCode = 1 << ++codeSize;
+  };
+
+  emit(clearCode);
+
+  int curCode = numPixel > 0 ? index[0] : 0;
+
+  for(int i = 1; i < numPixel; i++)
+  {
+    int key  = (curCode << 8) | index[i];
+    int slot = static_cast<int>( (static_cast<uint32_t>(key) * 2654435761u) >> 19 );
+
+    while(hashKey[slot] != -1 && hashKey[slot] != key)
+      slot = (slot + 1) & (GIF_HASH_SIZE - 1);
+
+    if(hashKey[slot] == key)
+    {
+      curCode = hashCode[slot];
+      continue;
+    }
+
+    emit(curCode);
+
+    curCode = index[i];
+
+    if(nextCode >= GIF_MAX_CODE)
+    {
+      // Table is full : start over
+      emit(clearCode);
+
+      std::fill(hashKey.begin(), hashKey.end(), -1);
+
+      codeSize = GIF_MIN_CODE_SIZE + 1;
+      nextCode = eoiCode + 1;
+      maxCode  = 1 << codeSize;
+    }
+    else
+    {
+      hashKey[slot]  = key;
+      hashCode[slot] = nextCode++;
+    }
+  }
+
+  emit(curCode);
+  emit(eoiCode);
+
+  lzw.flush();
+
+  return out;
+}
+
+bool
+GifWriter::write(const std::string& fileName,
+                 const std::vector<std::vector<unsigned char>>& frames) const
+{
+  FILE* fp = std::fopen(fileName.c_str(), "wb");
+
+  if(fp == nullptr)
+    return false;
+
+  std::vector<unsigned char> header;
+
+  // Logical Screen Descriptor (256 colors global color table)
+  header.insert(header.end(), { 'G', 'I', 'F', '8', '9', 'a',
+                                static_cast<unsigned char>(width_  & 0xFF),
+                                static_cast<unsigned char>(width_  >> 8),
+                                static_cast<unsigned char>(height_ & 0xFF),
+                                static_cast<unsigned char>(height_ >> 8),
+                                0xF7, 0x00, 0x00 } );
+
+  // 6x6x6 web-safe colors (the rest is black)
+  for(int i = 0; i < 256; i++)
+  {
+    if(i < 216)
+    {
+      header.push_back( (i / 36)     * 51 );
+      header.push_back( (i / 6 % 6)  * 51 );
+      header.push_back( (i % 6)      * 51 );
+    }
+    else
+      header.insert(header.end(), { 0, 0, 0 } );
+  }
+
+  // NETSCAPE2.0 Application Extension (loop forever)
+  header.insert(header.end(), { 0x21, 0xFF, 0x0B,
+                                'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+                                0x03, 0x01, 0x00, 0x00, 0x00 } );
+
+  bool success = std::fwrite(header.data(), 1, header.size(), fp) == header.size();
+
+  for(const auto& frame : frames)
+    success &= std::fwrite(frame.data(), 1, frame.size(), fp) == frame.size();
+
+  success &= std::fputc(0x3B, fp) != EOF; // Trailer
+  success &= std::fclose(fp) == 0;
+
+  return success;
+}
+
+} // namespace Graphic
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "CImgFwd.h"
+
+namespace Graphic
+{
+
+// Animated GIF (GIF89a) writer
+// Every frame is quantized to the 6x6x6 web-safe palette (global color table)
+// and LZW-compressed by encodeFrame(), which is const and can be called
+// from multiple threads. write() only concatenates the compressed frames.
+class GifWriter
+{
+  public:
+
+    GifWriter(int width, int height, int delay)             // delay : 1/100 s
+      : width_ (width), height_ (height), delay_ (delay) {}
+
+    // Graphic Control Extension + Image Descriptor + LZW data of one frame
+    std::vector<unsigned char> encodeFrame(const cimg_library::CImg<unsigned char>& img) const;
+
+    // Header + Global Color Table + Loop Extension + frames + Trailer
+    bool write(const std::string& fileName,                 // false if the file cannot be written
+               const std::vector<std::vector<unsigned char>>& frames) const;
+
+  private:
+
+    int width_;
+    int height_;
+    int delay_;
+};
+
+} // namespace Graphic
@@ -0,0 +1,474 @@
+#include "GridIndex.h"
+#include "Parallel.h"
+
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+namespace LefDefDB
+{
+
+// Cells wider / taller than this many bins are not put in the bins
+static constexpr int bigCellBins = 4;
+
+// Squared distance from (x, y) to the rectangle (0 inside)
+inline int64_t distance2(int x, int y, int lx, int ly, int ux, int uy)
+{
+  int64_t dx = x < lx ? lx - x : (x > ux ? x - ux : 0);
+  int64_t dy = y < ly ? ly - y : (y > uy ? y - uy : 0);
+  return dx * dx + dy * dy;
+}
+
+int
+GridIndex::binX(int x) const
+{
+  int bx = (static_cast<int64_t>(x) - lx_) / binSize_;
+  return std::max(0, std::min(numBinX_ - 1, bx));
+}
+
+int
+GridIndex::binY(int y) const
+{
+  int by = (static_cast<int64_t>(y) - ly_) / binSize_;
+  return std::max(0, std::min(numBinY_ - 1, by));
+}
+
+int
+GridIndex::cellBin(const dbCell* cell) const
+{
+  if(cell->dx() > bigCellBins * binSize_ || cell->dy() > bigCellBins * binSize_)
+    return -1;
+
+  return binY(cell->ly()) * numBinX_ + binX(cell->lx());
+}
+
+int
+GridIndex::pinBin(const dbPin* pin) const
+{
+  int x, y;
+  pinLocation(pin, x, y);
+
+  return binY(y) * numBinX_ + binX(x);
+}
+
+template<typename BinOf>
+void
+GridIndex::buildBins(Bins& bins, int numItem, BinOf binOf)
+{
+  const int numBin = numBinX_ * numBinY_;
+
+  // Step #1: Bin of each item (in parallel, this reads the DB)
+  std::vector<int> itemBin(numItem);
+
+  const int numThreads = std::max(1, std::min(db_->numThreads(), numItem / 4096));
+
+  runChunks(numThreads, numItem, [&] (int t, int begin, int end)
+  {
+    for(int i = begin; i < end; i++)
+      itemBin[i] = binOf(i);
+  });
+
+  // Step #2: Capacity of each bin (items + 1/4 + 1 free slots)
+  bins.count.assign(numBin, 0);
+
+  for(int b : itemBin)
+  {
+    if(b >= 0)
+      bins.count[b]++;
+  }
+
+  bins.start.resize(numBin + 1);
+  bins.start[0] = 0;
+
+  for(int b = 0; b < numBin; b++)
+    bins.start[b + 1] = bins.start[b] + bins.count[b] + bins.count[b] / 4 + 1;
+
+  // Step #3: Scatter (items of a bin are in the order of their IDs)
+  bins.items.assign(bins.start[numBin], -1);
+  bins.slot.assign(numItem, -2);
+  bins.overflow.clear();
+
+  std::fill(bins.count.begin(), bins.count.end(), 0);
+
+  for(int i = 0; i < numItem; i++)
+  {
+    int b = itemBin[i];
+
+    if(b < 0)
+      continue;
+
+    int s = bins.start[b] + bins.count[b]++;
+
+    bins.items[s] = i;
+    bins.slot[i]  = s;
+  }
+}
+
+void
+GridIndex::rebuildCells()
+{
+  const std::vector<dbCell*>& cells = db_->cells();
+
+  buildBins(cellBins_, cells.size(), [&] (int i) { return cellBin(cells[i]); });
+}
+
+void
+GridIndex::rebuildPins()
+{
+  const std::vector<dbPin*>& pins = db_->pins();
+
+  buildBins(pinBins_, pins.size(), [&] (int i) { return pinBin(pins[i]); });
+}
+
+Status
+GridIndex::build(int binSize)
+{
+  if(!db_->isDefLoaded())
+    return Status::error("Error - Please read DEF first!");
+
+  const dbDie* die = db_->die();
+
+  if(die->ux() <= die->lx() || die->uy() <= die->ly())
+    return Status::error("Die is empty. Please read .def first.");
+
+  if(binSize < 0)
+    return Status::error("Bin size should be positive...");
+
+  if(binSize == 0)
+  {
+    const std::vector<dbRow*>& rows = db_->rows();
+
+    if(!rows.empty() && rows.front()->sizeY() > 0)
+      binSize = rows.front()->sizeY();
+    else
+    {
+      // No row : about one cell per bin
+      double area = double(die->ux() - die->lx()) * double(die->uy() - die->ly());
+      binSize = std::max(1, static_cast<int>( std::sqrt(area / std::max<size_t>(1, db_->cells().size())) ));
+    }
+  }
+
+  binSize_ = binSize;
+
+  lx_ = die->lx();
+  ly_ = die->ly();
+
+  numBinX_ = (static_cast<int64_t>(die->ux()) - lx_ + binSize_ - 1) / binSize_;
+  numBinY_ = (static_cast<int64_t>(die->uy()) - ly_ + binSize_ - 1) / binSize_;
+
+  // Largest cell in the bins / list of the big cells
+  maxCellW_ = 0;
+  maxCellH_ = 0;
+
+  bigCells_.clear();
+
+  for(const dbCell* cell : db_->cells())
+  {
+    if(cellBin(cell) < 0)
+      bigCells_.push_back(cell->id());
+    else
+    {
+      maxCellW_ = std::max(maxCellW_, cell->dx());
+      maxCellH_ = std::max(maxCellH_, cell->dy());
+    }
+  }
+
+  rebuildCells();
+  rebuildPins();
+
+  return Status();
+}
+
+void
+GridIndex::remove(Bins& bins, int item, int bin)
+{
+  int s = bins.slot[item];
+
+  if(s == -1)
+  {
+    auto itr = std::find(bins.overflow.begin(), bins.overflow.end(), item);
+    *itr = bins.overflow.back();
+    bins.overflow.pop_back();
+  }
+  else
+  {
+    // The last item of the bin fills the hole
+    int last = bins.start[bin] + --bins.count[bin];
+
+    bins.items[s]              = bins.items[last];
+    bins.slot[bins.items[s]]   = s;
+    bins.items[last]           = -1;
+  }
+
+  bins.slot[item] = -2;
+}
+
+bool
+GridIndex::insert(Bins& bins, int item, int bin)
+{
+  if(bins.start[bin] + bins.count[bin] < bins.start[bin + 1])
+  {
+    int s = bins.start[bin] + bins.count[bin]++;
+
+    bins.items[s]   = item;
+    bins.slot[item] = s;
+
+    return true;
+  }
+
+  bins.overflow.push_back(item);
+  bins.slot[item] = -1;
+
+  return false;
+}
+
+void
+GridIndex::moveCell(int cellID, int lx, int ly)
+{
+  const dbCell* cell = db_->cells()[cellID];
+
+  // Bins of the old position
+  const int oldBin = cellBin(cell);
+
+  thread_local std::vector<int> oldPinBins;
+  oldPinBins.clear();
+
+  for(const dbPin* pin : cell->pins())
+    oldPinBins.push_back( pinBin(pin) );
+
+  db_->moveCell(cellID, lx, ly);
+
+  // Items are moved only if the bin is changed
+  if(int newBin = cellBin(cell); oldBin >= 0 && newBin != oldBin)
+  {
+    remove(cellBins_, cellID, oldBin);
+    insert(cellBins_, cellID, newBin);
+  }
+
+  for(size_t i = 0; i < cell->pins().size(); i++)
+  {
+    const dbPin* pin = cell->pins()[i];
+
+    if(int newBin = pinBin(pin); newBin != oldPinBins[i])
+    {
+      remove(pinBins_, pin->id(), oldPinBins[i]);
+      insert(pinBins_, pin->id(), newBin);
+    }
+  }
+
+  // Overflow is scanned by every query
+  const size_t maxOverflow = 1024;
+
+  if(cellBins_.overflow.size() > std::max(maxOverflow, db_->cells().size() / 64))
+    rebuildCells();
+
+  if(pinBins_.overflow.size() > std::max(maxOverflow, db_->pins().size() / 64))
+    rebuildPins();
+}
+
+template<typename Func>
+void
+GridIndex::forEachInBins(const Bins& bins, int bx1, int by1, int bx2, int by2, Func func) const
+{
+  for(int by = by1; by <= by2; by++)
+  {
+    for(int bx = bx1; bx <= bx2; bx++)
+    {
+      const int b     = by * numBinX_ + bx;
+      const int begin = bins.start[b];
+      const int end   = begin + bins.count[b];
+
+      for(int s = begin; s < end; s++)
+        func(bins.items[s]);
+    }
+  }
+
+  for(int item : bins.overflow)
+    func(item);
+}
+
+void
+GridIndex::cellsInBox(int lx, int ly, int ux, int uy, std::vector<int>& cellIDs) const
+{
+  if(binSize_ == 0)
+    return;
+
+  const std::vector<dbCell*>& cells = db_->cells();
+
+  auto check = [&] (int cellID)
+  {
+    const dbCell* cell = cells[cellID];
+
+    if(cell->lx() < ux && cell->ux() > lx && cell->ly() < uy && cell->uy() > ly)
+      cellIDs.push_back(cellID);
+  };
+
+  // A cell whose lower-left is left / below the box can still overlap it
+  forEachInBins(cellBins_, binX(lx - maxCellW_), binY(ly - maxCellH_),
+                           binX(ux), binY(uy), check);
+
+  for(int cellID : bigCells_)
+    check(cellID);
+}
+
+void
+GridIndex::pinsInBox(int lx, int ly, int ux, int uy, std::vector<int>& pinIDs) const
+{
+  if(binSize_ == 0)
+    return;
+
+  const std::vector<dbPin*>& pins = db_->pins();
+
+  forEachInBins(pinBins_, binX(lx), binY(ly), binX(ux), binY(uy), [&] (int pinID)
+  {
+    int x, y;
+    pinLocation(pins[pinID], x, y);
+
+    if(x >= lx && x <= ux && y >= ly && y <= uy)
+      pinIDs.push_back(pinID);
+  });
+}
+
+int
+GridIndex::nearestCell(int x, int y) const
+{
+  if(binSize_ == 0)
+    return -1;
+
+  const std::vector<dbCell*>& cells = db_->cells();
+
+  int     best  = -1;
+  int64_t bestD = INT64_MAX;
+
+  auto check = [&] (int cellID)
+  {
+    const dbCell* cell = cells[cellID];
+
+    int64_t d = distance2(x, y, cell->lx(), cell->ly(), cell->ux(), cell->uy());
+
+    if(d < bestD || (d == bestD && cellID < best))
+    {
+      best  = cellID;
+      bestD = d;
+    }
+  };
+
+  for(int cellID : bigCells_)
+    check(cellID);
+
+  for(int cellID : cellBins_.overflow)
+    check(cellID);
+
+  // Rings of bins around the bin of (x, y)
+  // Lower-left corners beyond ring r are farther than r bins,
+  // and the cells reach back toward (x, y) by their size at most.
+  const int    bx    = binX(x);
+  const int    by    = binY(y);
+  const double reach = std::hypot(double(maxCellW_), double(maxCellH_));
+  const int    maxR  = std::max(numBinX_, numBinY_);
+
+  for(int r = 0; r <= maxR; r++)
+  {
+    const int bx1 = bx - r;
+    const int bx2 = bx + r;
+    const int by1 = by - r;
+    const int by2 = by + r;
+
+    for(int b_y = std::max(0, by1); b_y <= std::min(numBinY_ - 1, by2); b_y++)
+    {
+      // Only the border of the ring (the inside is visited already)
+      const bool isEdge = (b_y == by1 || b_y == by2);
+      const int  step   = isEdge ? 1 : std::max(1, bx2 - bx1);
+
+      for(int b_x = bx1; b_x <= bx2; b_x += step)
+      {
+        if(b_x < 0 || b_x >= numBinX_)
+          continue;
+
+        const int b     = b_y * numBinX_ + b_x;
+        const int begin = cellBins_.start[b];
+        const int end   = begin + cellBins_.count[b];
+
+        for(int s = begin; s < end; s++)
+          check(cellBins_.items[s]);
+      }
+    }
+
+    const double bound = double(r) * binSize_ - reach;
+
+    if(best >= 0 && bound > 0 && bound * bound >= double(bestD))
+      break;
+  }
+
+  return best;
+}
+
+int
+GridIndex::nearestPin(int x, int y) const
+{
+  if(binSize_ == 0)
+    return -1;
+
+  const std::vector<dbPin*>& pins = db_->pins();
+
+  int     best  = -1;
+  int64_t bestD = INT64_MAX;
+
+  auto check = [&] (int pinID)
+  {
+    int px, py;
+    pinLocation(pins[pinID], px, py);
+
+    int64_t d = distance2(x, y, px, py, px, py);
+
+    if(d < bestD || (d == bestD && pinID < best))
+    {
+      best  = pinID;
+      bestD = d;
+    }
+  };
+
+  for(int pinID : pinBins_.overflow)
+    check(pinID);
+
+  const int bx   = binX(x);
+  const int by   = binY(y);
+  const int maxR = std::max(numBinX_, numBinY_);
+
+  for(int r = 0; r <= maxR; r++)
+  {
+    const int bx1 = bx - r;
+    const int bx2 = bx + r;
+    const int by1 = by - r;
+    const int by2 = by + r;
+
+    for(int b_y = std::max(0, by1); b_y <= std::min(numBinY_ - 1, by2); b_y++)
+    {
+      const bool isEdge = (b_y == by1 || b_y == by2);
+      const int  step   = isEdge ? 1 : std::max(1, bx2 - bx1);
+
+      for(int b_x = bx1; b_x <= bx2; b_x += step)
+      {
+        if(b_x < 0 || b_x >= numBinX_)
+          continue;
+
+        const int b     = b_y * numBinX_ + b_x;
+        const int begin = pinBins_.start[b];
+        const int end   = begin + pinBins_.count[b];
+
+        for(int s = begin; s < end; s++)
+          check(pinBins_.items[s]);
+      }
+    }
+
+    // Pins beyond ring r are farther than r bins
+    const double bound = double(r) * binSize_;
+
+    if(best >= 0 && bound * bound >= double(bestD))
+      break;
+  }
+
+  return best;
+}
+
+} // namespace LefDefDB
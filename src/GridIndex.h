@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "LefDefParser.h"
+
+namespace LefDefDB
+{
+
+// Uniform grid over the die for region queries of cells and pins
+// Bins are squares (one row height by default) stored in CSR form.
+// A cell is put in the bin of its lower-left corner (queries are expanded by the largest cell),
+// and cells larger than 4 bins (macros) are kept in a separate list.
+// A pin is put in the bin of its location.
+//
+// Each bin has a few free slots for moveCell. An item moved into a full bin
+// goes to an overflow list, and the grid is rebuilt when the list gets long.
+class GridIndex
+{
+  public:
+
+    GridIndex(std::shared_ptr<LefDefParser> db) : db_ (db) {}
+
+    Status build(int binSize = 0);                          // dbu (0 : row height)
+
+    // Rectangle queries (IDs are appended in no particular order)
+    void cellsInBox(int lx, int ly, int ux, int uy,         // Cells overlapping the box (touching is not counted)
+                    std::vector<int>& cellIDs) const;
+    void pinsInBox (int lx, int ly, int ux, int uy,         // Pins inside the box (boundary included)
+                    std::vector<int>& pinIDs) const;
+
+    // Nearest neighbor by Euclidean distance (-1 if there is none)
+    int nearestCell(int x, int y) const;                    // 0 inside a cell
+    int nearestPin (int x, int y) const;
+
+    void moveCell(int cellID, int lx, int ly);              // LefDefParser::moveCell + update of the index
+
+    // Getters
+    int binSize() const { return binSize_; }
+    int numBinX() const { return numBinX_; }
+    int numBinY() const { return numBinY_; }
+
+  private:
+
+    std::shared_ptr<LefDefParser> db_;
+
+    int binSize_ = 0;
+    int numBinX_ = 0;
+    int numBinY_ = 0;
+
+    int lx_      = 0;                                       // Lower-left of the die
+    int ly_      = 0;
+
+    int maxCellW_ = 0;                                      // Largest cell in the bins
+    int maxCellH_ = 0;
+
+    // Items of bin b are items[start[b], start[b] + count[b])
+    // (items[start[b] + count[b], start[b + 1]) are free slots)
+    struct Bins
+    {
+      std::vector<int> start;
+      std::vector<int> count;
+      std::vector<int> items;
+      std::vector<int> slot;                                // Index of each item in items
+                                                            // (-1 : in overflow, -2 : not in the bins)
+      std::vector<int> overflow;
+    };
+
+    Bins cellBins_;
+    Bins  pinBins_;
+
+    std::vector<int> bigCells_;                             // Cells not in the bins (macros)
+
+    int binX(int x) const;                                  // Clamped to the grid
+    int binY(int y) const;
+
+    int cellBin(const dbCell* cell) const;                  // -1 if the cell is big
+    int pinBin (const dbPin*  pin ) const;
+
+    // Counting sort of the items by binOf(item) (-1 : not in the bins)
+    template<typename BinOf>
+    void buildBins(Bins& bins, int numItem, BinOf binOf);
+
+    void rebuildCells();
+    void rebuildPins ();
+
+    static void remove(Bins& bins, int item, int bin);
+    static bool insert(Bins& bins, int item, int bin);      // false if it went to the overflow
+
+    // Visit the items of the bins in [bx1, bx2] x [by1, by2] and the overflow
+    template<typename Func>
+    void forEachInBins(const Bins& bins, int bx1, int by1, int bx2, int by2, Func func) const;
+};
+
+} // namespace LefDefDB
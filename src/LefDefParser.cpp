@@ -6,48 +6,190 @@
 #include <sstream>
 #include <algorithm>
 #include <cfloat>
-#include <regex>
+#include <cctype>
+#include <cstdlib>
+#include <thread>
+#include <unordered_set>
 
 #include "LefDefParser.h"
+#include "Profiler.h"
+#include "TextScan.h"
+#include "Parallel.h"
 
 namespace LefDefDB
 {
 
-inline bool isNumeric(const std::string& str)
+// Every error of the readers ends up here :
+// the message is thrown as a ParseError, and the API that started
+// the read rolls the DB back and returns the message as a Status.
+template <typename... Args>
+[[noreturn]] void parseError(const Args&... args)
 {
-  return std::regex_match( str, std::regex("[0-9]+") );
+  std::ostringstream oss;
+  (oss << ... << args);
+  throw ParseError(oss.str());
 }
 
-// Check if the given string is contained in the squared bracket
-inline bool isSqrBracket(const std::string& str)
+// Syntax check of a keyword token (e.g. "BY" in SIZE xx BY yy)
+inline void expectToken(const std::string& token, const char* expected)
 {
-  return (str[0] == '[' && str.back() == ']');
+  if(token != expected)
+    parseError("Syntax Error - ", expected, " is expected but ", token, " is given.");
 }
 
-inline void getBusNumber(const std::string& str, int& numBus, int& offset)
+// Runs load() and returns its error as a Status
+// after rollback() has restored the DB.
+// (std::stoi / std::stof throw std::invalid_argument or std::out_of_range)
+template <typename Load, typename Rollback>
+Status runLoad(const std::filesystem::path& path, Load load, Rollback rollback)
 {
-  // RegExp-> xx:yy
-  std::regex re("([0-9]+):[0-9]+");
-  std::regex nu("([0-9]+)");
+  std::string message;
 
-  // str => [xx:yy]
-  auto begin = std::sregex_iterator( str.begin() + 1, str.end() - 1, re);
-  auto end   = std::sregex_iterator();
+  try
+  {
+    load();
+    return Status();
+  }
+  catch(const ParseError& e)            { message = e.what(); }
+  catch(const std::invalid_argument& e) { message = std::string("Error - Invalid number (") + e.what() + ")"; }
+  catch(const std::out_of_range& e)     { message = std::string("Error - Out of range (") + e.what() + ")"; }
+  catch(const std::bad_alloc&)          { message = "Error - Out of memory"; }
+
+  rollback();
+
+  return Status::error(std::string(path) + " : " + message);
+}
+
+// assign lhs = rhs; (bits of both sides are MSB first)
+// Same rule for the top module and submodules : bits are aligned from LSB,
+// extra bits of rhs are truncated and extra bits of lhs are left undriven.
+template<typename AssignBit>
+inline void alignAssign(const std::vector<int>& lhs, 
+                        const std::vector<int>& rhs,
+                        const std::vector<std::string>& lhsNames, 
+                        AssignBit assignBit)
+{
+  size_t numBit = std::min(lhs.size(), rhs.size());
+
+  for(size_t i = 1; i <= numBit; i++)
+    assignBit(lhs[lhs.size() - i], rhs[rhs.size() - i]);
 
-  if(begin == end)
+  if(lhs.size() > rhs.size())
   {
-    std::cout << "Bus syntax error..." << std::endl;
-    std::cout << str << std::endl;
-    exit(0);
+    std::string names;
+
+    for(auto& name : lhsNames)
+      names += (names.empty() ? "" : ", ") + name;
+
+    std::cout << "[WARNING] assign to " << names << " : " << lhs.size() - rhs.size();
+    std::cout << " upper bits are not driven (rhs is narrower)." << std::endl;
   }
+}
 
-  auto nuRegItr = std::sregex_iterator( str.begin() + 1, str.end() - 1, nu);
-  
-  int bit1 = std::stoi( nuRegItr->str() );
-  int bit2 = std::stoi( (++nuRegItr)->str() );
+// Decode a sized constant (e.g. 1'b0, 4'b0101, 8'hff) into bits (MSB first)
+// Returns false if the given string is not a constant
+inline bool getConstBits(const std::string& item, std::vector<int>& bits, int tie0, int tie1)
+{
+  size_t quote = item.find('\'');
+
+  if(quote == std::string::npos || quote + 2 > item.size())
+    return false;
+
+  char base = std::tolower( item[quote + 1] );
+
+  int bitPerDigit = 0;
+
+  if(base == 'b')
+    bitPerDigit = 1;
+  else if(base == 'o')
+    bitPerDigit = 3;
+  else if(base == 'h')
+    bitPerDigit = 4;
+  else if(base != 'd')
+    return false;
+
+  // Bits from LSB
+  std::vector<int> values;
+
+  if(bitPerDigit > 0)
+  {
+    for(size_t i = item.size(); i > quote + 2; i--)
+    {
+      char c = std::tolower( item[i - 1] );
+
+      if(c == '_')
+        continue;
+
+      int digit = 0; // x and z are regarded as 0
+
+      if(c >= '0' && c <= '9')
+        digit = c - '0';
+      else if(c >= 'a' && c <= 'f')
+        digit = c - 'a' + 10;
+
+      for(int b = 0; b < bitPerDigit; b++)
+        values.push_back( (digit >> b) & 1 );
+    }
+  }
+  else
+  {
+    unsigned long long decimal = std::stoull( item.substr(quote + 2) );
+    for(int b = 0; b < 64; b++)
+      values.push_back( (decimal >> b) & 1 );
+  }
+
+  int width = (quote == 0) ? values.size() : std::stoi( item.substr(0, quote) );
+
+  values.resize(width, 0);
 
-  numBus = bit1 - bit2 + 1;
-  offset = bit2;
+  for(int b = width - 1; b >= 0; b--)
+    bits.push_back( values[b] ? tie1 : tie0 );
+
+  return true;
+}
+
+// Collect the items of the net expression inside the parentheses pair
+// ( {a, b [1], w[3:0], 2'b01} ) -> { "a", "b[1]", "w[3:0]", "2'b01" }
+// itr should point "(" at the beginning, and ")" at the end
+inline void readNetExprItems(strIter& itr, const strIter& end, 
+                             std::vector<std::string>& items, bool& isConcat)
+{
+  int stack = 0;
+
+  isConcat = false;
+
+  for(; itr != end; ++itr)
+  {
+    if(*itr == "(")
+      stack++;
+    else if(*itr == ")")
+    {
+      if(--stack == 0)
+        break;
+    }
+    else if(*itr == "{")
+      isConcat = true;
+    else if(*itr == "}")
+      continue;
+    else if( isSqrBracket(*itr) && !items.empty() )
+      items.back() += *itr; // xx [3] -> xx[3]
+    else
+      items.push_back(*itr);
+  }
+
+  if(itr == end)
+  {
+    parseError("Syntax error in net expression.");
+  }
+}
+
+// str => [msb:lsb]
+inline void getBusNumber(const std::string& str, int& msb, int& lsb)
+{
+  if( !parseBracketRange(str, msb, lsb) )
+  {
+    parseError("Bus syntax error... ", str);
+  }
 }
 
 // Iteratively apply closure c on each token inside the parentheses pair
@@ -100,9 +242,7 @@ void checkIfKeyExist(K key, M& map, V& value, const std::string keyType)
 
   if(checkKey == map.end())
   {
-    std::cout << "Error " + keyType + " ";
-    std::cout << key << " is missing in DB." << std::endl;
-    exit(0);
+    parseError("Error ", keyType, " ", key, " is missing in DB.");
   }
   else
     value = checkKey->second;
@@ -129,6 +269,9 @@ LefMacro::printInfo() const
 {
   using namespace std;
 
+  // Stream state is restored at the end
+  ios_base::fmtflags flags = cout.flags();
+
   cout << "----------------------------------------" << endl;
   cout << "MACRO : " << setw(10) << left         << macroName_ << endl;;
   cout << "SIZEX : " << setw(4 ) << setfill(' ') << sizeX_     << endl;
@@ -149,6 +292,8 @@ LefMacro::printInfo() const
 
   cout << endl;
   cout << "----------------------------------------" << endl;
+
+  cout.flags(flags);
 }
 
 void
@@ -156,8 +301,8 @@ LefPin::computeBBox()
 {
   float minX = FLT_MAX;
   float minY = FLT_MAX;
-  float maxX = FLT_MIN;
-  float maxY = FLT_MIN;
+  float maxX = -FLT_MAX;
+  float maxY = -FLT_MAX;
 
   for(auto& r : lefRect_)
   {
@@ -166,9 +311,9 @@ LefPin::computeBBox()
     float ux = r.ux;
     float uy = r.uy;
 
-    if(minX < lx)
+    if(lx < minX)
       minX = lx;
-    if(minY < ly)
+    if(ly < minY)
       minY = ly;
     if(maxX < ux)
       maxX = ux;
@@ -203,15 +348,12 @@ LefDefParser::tokenize(const std::filesystem::path& path,
                        std::string_view dels,
                        std::string_view exps) 
 {
-  using namespace std::literals::string_literals;
+  ProfileScope fileRead("file_read");
 
   std::ifstream ifs(path, std::ios::ate);
 
   if(!ifs.good()) 
-  {
-    throw std::invalid_argument("failed to open the file '"s + path.c_str() + '\'');
-    return {};
-  }
+    parseError("Error - Failed to open ", std::string(path));
   
   // Read the file to a local buffer.
   size_t fsize = ifs.tellg();
@@ -219,6 +361,10 @@ LefDefParser::tokenize(const std::filesystem::path& path,
   std::vector<char> buffer(fsize + 1);
   ifs.read(buffer.data(), fsize);
   buffer[fsize] = 0;
+
+  fileRead.stop();
+
+  ProfileScope tokenizeScope("tokenize");
   
   // Mark out the comment
   for(size_t i = 0; i < fsize; ++i) 
@@ -303,6 +449,17 @@ LefDefParser::tokenize(const std::filesystem::path& path,
   return tokens;
 }
 
+std::vector<std::string>
+LefDefParser::tokenize(const std::filesystem::path& path, FileType type)
+{
+  switch(type)
+  {
+    case FileType::LEF     : return tokenize(path, lefDelimiters_,     lefExceptions_    );
+    case FileType::VERILOG : return tokenize(path, verilogDelimiters_, verilogExceptions_);
+    default                : return tokenize(path, defDelimiters_,     defExceptions_    );
+  }
+}
+
 LefDefParser::LefDefParser()
   : // LEF-related
     dbUnit_            ( 1000),
@@ -320,6 +477,7 @@ LefDefParser::LefDefParser()
     // DEF-related
     numRow_            (    0),
     numDummy_          (    0),
+    numTieNet_         (    0),
     numDefComps_       (    0),
     sumTotalInstArea_  (    0),
     sumStdCellArea_    (    0),
@@ -327,6 +485,8 @@ LefDefParser::LefDefParser()
     util_              (  0.0),
     density_           (  0.0),
 
+    numThreads_        (std::max(1, static_cast<int>(std::thread::hardware_concurrency()))),
+
     ifReadLef_         (false),
     ifReadVerilog_     (false),
     ifReadDef_         (false)
@@ -379,6 +539,30 @@ LefDefParser::reset()
   lefList_.clear();
 
   // Verilog-related
+  clearNetlist();
+
+  perCellTie_   = false;
+
+  // DEF-related
+  numRow_           = 0;
+  numDefComps_      = 0;
+
+  sumTotalInstArea_ = 0;
+  sumStdCellArea_   = 0;
+  sumMacroArea_     = 0;
+
+  util_             = 0.0;
+  density_          = 0.0;
+
+  dbRowInsts_.clear();
+  dbRowPtrs_.clear();
+
+  defBase_ = DefBase();
+}
+
+void
+LefDefParser::clearNetlist()
+{
   designName_.clear();
   
   numPI_       = 0;
@@ -393,6 +577,7 @@ LefDefParser::reset()
 
   dbCellPtrs_.clear();
   dbCellInsts_.clear();
+  dbDummyInsts_.clear();
 
   dbPinPtrs_.clear();
   dbPinInsts_.clear();
@@ -408,19 +593,19 @@ LefDefParser::reset()
   strToPinID_.clear();
   strToIOID_.clear();
 
-  // DEF-related
-  numRow_           = 0;
-  numDefComps_      = 0;
+  strToBus_.clear();
 
-  sumTotalInstArea_ = 0;
-  sumStdCellArea_   = 0;
-  sumMacroArea_     = 0;
+  netParent_.clear();
+  netAlias_.clear();
 
-  util_             = 0.0;
-  density_          = 0.0;
+  numTieNet_    = 0;
+  tieNetID_[0]  = -1;
+  tieNetID_[1]  = -1;
 
-  dbRowInsts_.clear();
-  dbRowPtrs_.clear();
+  modules_.clear();
+  moduleMap_.clear();
+
+  ifReadVerilog_ = false;
 }
 
 void 
@@ -454,8 +639,7 @@ LefDefParser::readLefPinShape(strIter& itr, const strIter& end, LefPin* lefPin)
 
   if(itr == end)
   {
-    std::cout << "Syntax Error in LEF." << std::endl;
-    exit(0);
+    parseError("Syntax Error in LEF.");
   }
 }
 
@@ -496,18 +680,14 @@ LefDefParser::readLefPin(strIter& itr, const strIter& end, LefMacro* lefMacro)
 
   if(pinUsageCheck == strToPinUsage_.end())
   {
-    std::cout << "Error - PIN USAGE " << pinUsage;
-    std::cout << " is not supported yet." << std::endl;
-    exit(0);
+    parseError("Error - PIN USAGE ", pinUsage, " is not supported yet.");
   }
   else
     pUsage = pinUsageCheck->second;
 
   if(pinDirectionCheck == strToPinDirection_.end())
   {
-    std::cout << "Error - PIN DIRECTION " << pDirection;
-    std::cout << " is not supported yet." << std::endl;
-    exit(0);
+    parseError("Error - PIN DIRECTION ", pDirection, " is not supported yet.");
   }
   else
     pDirection = pinDirectionCheck->second;
@@ -520,9 +700,7 @@ LefDefParser::readLefPin(strIter& itr, const strIter& end, LefMacro* lefMacro)
 
   if(itr == end)
   {
-    std::cout << "Syntax Error in LEF." << std::endl;
-    std::cout << "No END keyword in PIN " << pinName << std::endl;
-    exit(0);
+    parseError("Syntax Error in LEF. No END keyword in PIN ", pinName);
   }
 }
 
@@ -558,7 +736,7 @@ LefDefParser::readLefMacro(strIter& itr, const strIter& end)
     else if(*itr == "SIZE")
     {
       sizeX = std::stof( *(++itr) );
-      assert(*(++itr) == "BY");
+      expectToken(*(++itr), "BY");
       sizeY = std::stof( *(++itr) );
     }
 
@@ -577,9 +755,7 @@ LefDefParser::readLefMacro(strIter& itr, const strIter& end)
 
   if(classCheck == strToMacroClass_.end())
   {
-    std::cout << "Error - CLASS " << macroClass;
-    std::cout << " is not supported yet." << std::endl;
-    exit(0);
+    parseError("Error - CLASS ", macroClass, " is not supported yet.");
   }
   else
     mcClass = classCheck->second;
@@ -588,9 +764,7 @@ LefDefParser::readLefMacro(strIter& itr, const strIter& end)
   {
     if(macroClass != "BLOCK") // BLOCK MACRO does not have SITE
     {
-      std::cout << "Error - SITE " << siteName;
-      std::cout << " is not found in the LEF." << std::endl;
-      exit(0);
+      parseError("Error - SITE ", siteName, " is not found in the LEF.");
     }
   }
   else
@@ -609,9 +783,7 @@ LefDefParser::readLefMacro(strIter& itr, const strIter& end)
 
   if(itr == end)
   {
-    std::cout << "Syntax Error in LEF."     << std::endl;
-    std::cout << "No END keyword in MACRO " << macroName << std::endl;
-    exit(0);
+    parseError("Syntax Error in LEF. No END keyword in MACRO ", macroName);
   }
 }
 
@@ -635,7 +807,7 @@ LefDefParser::readLefSite(strIter& itr, const strIter& end)
     else if(*itr == "SIZE")
     {
       sizeX = std::stof(*(++itr));
-      assert(*(++itr) == "BY");
+      expectToken(*(++itr), "BY");
       sizeY = std::stof(*(++itr));
     }
 
@@ -648,9 +820,7 @@ LefDefParser::readLefSite(strIter& itr, const strIter& end)
 
   if(siteClassCheck == strToSiteClass_.end())
   {
-    std::cout << "Error - SITE CLASS " << siteClass;
-    std::cout << " is not supported yet." << std::endl;
-    exit(0);
+    parseError("Error - SITE CLASS ", siteClass, " is not supported yet.");
   }
   else
     sClass = siteClassCheck->second;
@@ -665,9 +835,7 @@ LefDefParser::readLefSite(strIter& itr, const strIter& end)
 
   if(itr == end)
   {
-    std::cout << "Syntax Error in LEF." << std::endl;
-    std::cout << "No END keyword in SITE " << siteName << std::endl;
-    exit(0);
+    parseError("Syntax Error in LEF. No END keyword in SITE ", siteName);
   }
 }
 
@@ -678,7 +846,7 @@ LefDefParser::readLefUnit(strIter& itr, const strIter& end)
   {
     if(*itr == "DATABASE")
     {
-      assert(*(++itr) == "MICRONS");
+      expectToken(*(++itr), "MICRONS");
       dbUnit_ = std::stoi(*(++itr));
     }
     else if(*itr == "END" && *(++itr) == "UNITS")
@@ -687,14 +855,46 @@ LefDefParser::readLefUnit(strIter& itr, const strIter& end)
 
   if(itr == end)
   {
-    std::cout << "Syntax Error in LEF." << std::endl;
-    std::cout << "No END keyword in UNITS" << std::endl;
-    exit(0);
+    parseError("Syntax Error in LEF. No END keyword in UNITS");
   }
 }
 
+Status
+LefDefParser::readLef(const std::filesystem::path& path)
+{
+  // LEF objects are only appended (the checkpoint is their number)
+  size_t numMacro  = macros_.size();
+  size_t numSite   = sites_.size();
+  int    dbUnit    = dbUnit_;
+  bool   ifReadLef = ifReadLef_;
+  bool   isNewFile = lefList_.count(std::string(path)) == 0;
+
+  auto rollback = [&] ()
+  {
+    macros_.erase(macros_.begin() + numMacro, macros_.end());
+    sites_.erase (sites_.begin()  + numSite,  sites_.end());
+
+    dbUnit_    = dbUnit;
+    ifReadLef_ = ifReadLef;
+
+    if(isNewFile)
+      lefList_.erase(std::string(path));
+
+    macroMap_.clear();
+    siteMap_.clear();
+
+    for(auto& macro : macros_)
+      macroMap_[macro.name()] = &macro;
+
+    for(auto& site : sites_)
+      siteMap_[site.name()] = &site;
+  };
+
+  return runLoad(path, [&] () { readLefFile(path); }, rollback);
+}
+
 void 
-LefDefParser::readLef(const std::filesystem::path& fileName)
+LefDefParser::readLefFile(const std::filesystem::path& fileName)
 {
   std::string filenameStr = std::string(fileName);
 
@@ -705,14 +905,13 @@ LefDefParser::readLef(const std::filesystem::path& fileName)
 
   std::cout << "Read " << filenameStr << std::endl;
 
-  static std::string_view delimiters = "#;";
-  static std::string_view exceptions = "";
-  
-  auto tokens = tokenize(fileName, delimiters, exceptions);
+  auto tokens = tokenize(fileName, lefDelimiters_, lefExceptions_);
 
   auto itr = tokens.begin();
   auto end = tokens.end();
 
+  ProfileScope parse("parse");
+
   while(++itr != end) 
   {
     if(*itr == "SITE")
@@ -725,6 +924,10 @@ LefDefParser::readLef(const std::filesystem::path& fileName)
       break;
   }
 
+  parse.stop();
+
+  ProfileScope fixup("fixup");
+
   for(auto& macro : macros_)
     macroMap_[macro.name()] = &macro;
 
@@ -733,6 +936,50 @@ LefDefParser::readLef(const std::filesystem::path& fileName)
   // printLefStatistic();
 }
 
+Status
+LefDefParser::readLefMacros(std::vector<std::string>& tokens)
+{
+  if(!ifReadLef_)
+    return Status::error("Error - Please read LEF first!");
+
+  // Cells and pins point to the MACROs
+  if(ifReadVerilog_ || ifReadDef_)
+    return Status::error("Error - MACROs cannot be replaced after the netlist is loaded.");
+
+  std::vector<LefMacro> macros = std::move(macros_);
+  macros_.clear();
+
+  auto updateMap = [&] ()
+  {
+    macroMap_.clear();
+
+    for(auto& macro : macros_)
+      macroMap_[macro.name()] = &macro;
+  };
+
+  auto load = [&] ()
+  {
+    auto itr = tokens.begin();
+    auto end = tokens.end();
+
+    for(; itr != end; ++itr)
+    {
+      if(*itr == "MACRO")
+        readLefMacro(itr, end);
+    }
+
+    updateMap();
+  };
+
+  auto rollback = [&] ()
+  {
+    macros_ = std::move(macros);
+    updateMap();
+  };
+
+  return runLoad("MACRO tokens", load, rollback);
+}
+
 void 
 LefDefParser::printLefStatistic() const
 {
@@ -752,46 +999,56 @@ LefDefParser::printLefStatistic() const
 }
 
 // Verilog-related
+Status
+LefDefParser::readVerilog(const std::filesystem::path& path, bool perCellTie)
+{
+  if(!ifReadLef_)
+    return Status::error("Error - Please read LEF first!");
+
+  // The netlist is loaded at once (nothing to keep on failure)
+  if(!dbCellInsts_.empty() || !dbNetInsts_.empty())
+    return Status::error("Error - Netlist is already loaded.");
+
+  perCellTie_ = perCellTie;
+
+  return runLoad(path, [&] () { readVerilogFile(path); }, 
+                       [&] () { clearNetlist();       });
+}
+
 void
-LefDefParser::readVerilog(const std::filesystem::path& path)
+LefDefParser::readVerilogFile(const std::filesystem::path& path)
 {
   std::cout << "Read " << std::string(path) << std::endl;
 
-  if(!ifReadLef_)
-  {
-    std::cout << "Error - Please read LEF first!" << std::endl;
-    exit(0);
-  }
-
-  // static std::string_view delimiters = "(),:;/#[]{}*\"\\";
-  // static std::string_view exceptions = "().;";
-  static std::string_view delimiters = "(),;#{}*";
-  static std::string_view exceptions = "().;{}";
-  
-  auto tokens = tokenize(path, delimiters, exceptions);
+  auto tokens = tokenize(path, verilogDelimiters_, verilogExceptions_);
 
   auto itr = tokens.begin();
   auto end = tokens.end();
 
+  ProfileScope parse("parse");
+
   // Read the module name
-  itr = std::find(itr, end, "module");
+  VerilogModule* topModule = findTopModule(itr, end);
 
-  if(itr == end) 
+  if(topModule == nullptr) 
   {
-    std::cout << "No module keyworkd in the .v file." << std::endl;
-    exit(0);
+    parseError("No module keyworkd in the .v file.");
   }
   else 
   {
+    itr = topModule->begin();
+
     if(++itr == end) 
     {
-      std::cout << "Module name is invalid." << std::endl;
-      exit(0);
+      parseError("Module name is invalid.");
     }
     else
-      designName_ = std::move(*itr);
+      designName_ = *itr;
   }
 
+  // Instances of submodules in the top module
+  std::vector<HierInst> hierInsts;
+
   while(++itr != end && *itr != ";") 
   {
     if(*itr != "(" && *itr != ")") 
@@ -820,56 +1077,69 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
 
       // To handle [0:0] case...
       bool isBus = false;
-      int numBus = 1;
-      int offset = 0;
+      int msb = 0;
+      int lsb = 0;
 
       if( isSqrBracket( *(itr + 1) ) )
       {
         isBus  = true;
-        getBusNumber( *(++itr), numBus, offset);
+        getBusNumber( *(++itr), msb, lsb);
       }
 
       while(++itr != end && *itr != ";") 
       {
         std::string baseName = std::move( *(itr) );
-        std::string pinName  = baseName;
 
-        //std::cout << baseName << std::endl;
-        //std::cout << numBus << std::endl;
+        if(!isBus)
+        {
+          int pinID = numPin_;
+          int netID = numNet_;
+          int  ioID = numIO_;
+
+          dbIOInsts_.emplace_back(ioID, direction, baseName);
+          dbPinInsts_.emplace_back(pinID, netID, ioID, baseName);
+          dbNetInsts_.emplace_back(netID, baseName);
+
+          strToPinID_[baseName] = pinID;
+          strToNetID_[baseName] = netID;
+          strToIOID_[baseName]  = ioID;
+
+          numPin_++;
+          numNet_++;
+          numIO_++;
+
+          if(direction == PinDirection::INPUT)
+            numPI_++;
+          else
+            numPO_++;
+
+          continue;
+        }
 
         // input xx[31:16];
-        // numBus   = 16
-        // offset   = 16
+        // msb      = 31
+        // lsb      = 16
         // baseName = xx
-        // pinName  = baseName + i (i -> 16 ~ 31)
-        for(int curIdx = 0; curIdx < numBus; curIdx++)
-        {
-          if(numBus > 1)
-            pinName = baseName + "[" + std::to_string(curIdx + offset) + "]";
+        // ID of xx[i] = firstID + (i - 16)
+        // (the name of each bit is not made here)
+        auto [busItr, isNew] 
+          = strToBus_.try_emplace(baseName, msb, lsb, numNet_, numIO_, numPin_);
 
-          std::string netName = pinName;
-          std::string ioName  = pinName;
-  
+        if(!isNew)
+          continue;
+
+        const dbBus&       bus     = busItr->second;
+        const std::string* busName = &(busItr->first);
+
+        for(int bit = bus.low(); bit <= bus.high(); bit++)
+        {
           int pinID = numPin_;
           int netID = numNet_;
           int  ioID = numIO_;
   
-          dbIO io(ioID, direction, ioName);
-  
-          dbPin pin(pinID, 
-                    netID, 
-                    ioID,
-                    pinName);
-  
-          dbNet net(netID, netName);
-  
-          dbPinInsts_.push_back(pin);
-          dbNetInsts_.push_back(net);
-          dbIOInsts_.push_back(io);
-  
-          strToPinID_[pinName] = pinID;
-          strToNetID_[netName] = netID;
-          strToIOID_[ioName]   = ioID;
+          dbIOInsts_.emplace_back(ioID, direction, busName, bit);
+          dbPinInsts_.emplace_back(pinID, netID, ioID, busName, bit);
+          dbNetInsts_.emplace_back(netID, busName, bit);
   
           numPin_++;
           numNet_++;
@@ -886,53 +1156,68 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
     {
       // To handle [0:0] case...
       bool isBus = false;
-      int numBus = 1;
-      int offset = 0;
+      int msb = 0;
+      int lsb = 0;
 
       if( isSqrBracket( *(itr + 1) ) )
       {
         isBus  = true;
-        getBusNumber( *(++itr), numBus, offset);
+        getBusNumber( *(++itr), msb, lsb);
       }
 
+      auto printProgress = [&] ()
+      {
+        if(numNet_ % 200000 == 0)
+        {
+          using namespace std;
+          cout << "  Read ";
+          cout << setw(7) << right << numNet_ << " Nets..." << endl;
+        }
+      };
+
       while( ++itr != end && *itr != ";")
       {
         std::string baseName = std::move( *(itr) );
-          
+
+        // If a netName exists already, then do not make new net instance.
+        // This is because of the weird syntax of verilog netlist.
+        // Sometimes there are cases that there is already "input netNameX;",
+        // but netNameX is redefiend again like "wire netNameX;"
+        // In this case, netNameX will be double-counted.
+        if(!isBus)
+        {
+          if( strToNetID_.find(baseName) != strToNetID_.end() )
+            continue;
+
+          dbNetInsts_.emplace_back(numNet_, baseName);
+          strToNetID_[baseName] = numNet_;
+
+          numNet_++;
+          printProgress();
+          continue;
+        }
+
         // wire xx[31:16];
-        // numBus   = 16
-        // offset   = 16
+        // msb      = 31
+        // lsb      = 16
         // baseName = xx
-        // pinName  = baseName + i (i -> 16 ~ 31)
-        for(int curIdx = 0; curIdx < numBus; curIdx++)
+        // ID of xx[i] = firstID + (i - 16)
+        // (the name of each bit is not made here)
+        auto [busItr, isNew] 
+          = strToBus_.try_emplace(baseName, msb, lsb, numNet_, -1, -1);
+
+        if(!isNew)
+          continue;
+
+        const dbBus&       bus     = busItr->second;
+        const std::string* busName = &(busItr->first);
+
+        for(int bit = bus.low(); bit <= bus.high(); bit++)
         {
-          int netID = numNet_;
-          std::string netName = baseName;
+          dbNetInsts_.emplace_back(numNet_, busName, bit);
 
-          if( strToNetID_.find(netName) != strToNetID_.end() )
-            continue;
-          // If a netName exists already, then do not make new net instance.
-          // This is because of the weird syntax of verilog netlist.
-          // Sometimes there are cases that there is already "input netNameX;",
-          // but netNameX is redefiend again like "wire netNameX;"
-          // In this case, netNameX will be double-counted.
-  
-          if(numBus > 1 || isBus)
-            netName = baseName + "[" + std::to_string(curIdx + offset) + "]";
-  
-          dbNet net(netID, netName);
-          dbNetInsts_.push_back(net);
-  
-          strToNetID_[netName] = netID;
-  
           numNet_++;
-  
-          if(numNet_ % 200000 == 0)
-          {
-            using namespace std;
-            cout << "  Read ";
-            cout << setw(7) << right << numNet_ << " Nets..." << endl;
-          }
+          printProgress();
         }
       }
     }
@@ -940,15 +1225,11 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
     {
       std::string macroName = std::move(*itr);
 
-      // TODO
-      // how to handle "assign"?
       if(macroName == "assign")
-      {
-        std::string netName = std::string( *(++itr) );
-
-        while( *(itr + 1) != ";" && itr != end)
-          itr++;
-      }
+        readVerilogAssign(itr, end);
+      else if(auto findModule = moduleMap_.find(macroName); 
+              findModule != moduleMap_.end() && macroMap_.count(macroName) == 0)
+        readHierInst(itr, end, findModule->second, hierInsts);
       else
       {
         LefMacro* lefMacro;
@@ -962,8 +1243,7 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
   
         if(++itr == end) 
         {
-          std::cout << "Syntax error while reading Verilog." << std::endl;
-          exit(0);
+          parseError("Syntax error while reading Verilog.");
         }
   
         int cellID = numInst_;
@@ -981,7 +1261,28 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
         strToCellID_[cellName] = cellID;
   
         std::string portName;
-        std::string netName;
+        std::string lefPinName;
+
+        std::vector<std::string> items;
+        std::vector<int> bits;
+
+        // Tie stubs of this instance (only for per-cell tie mode)
+        int cellTieNetID[2] = {-1, -1};
+
+        auto getTieNetID = [&] (int value)
+        {
+          if(!perCellTie_)
+            return getSharedTieNetID(value);
+
+          if(cellTieNetID[value] == -1)
+          {
+            std::string tieName = (value ? "TIE1:" : "TIE0:") + cellName;
+            cellTieNetID[value] = makeTieNet(tieName);
+            strToNetID_[tieName] = cellTieNetID[value];
+          }
+
+          return cellTieNetID[value];
+        };
 
         itr = findParenthesePair(itr, end, [&] (const std::string& str, strIter& iter) mutable { 
           if(str == ")" || str == "(") 
@@ -990,73 +1291,77 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
             portName = std::move( str.substr(1) );
           else 
           {
-            // TODO
-            // how to handle 1'b0?
-            if(str == "1'b0" || str == "1'b1")
+            bool isBus;
+
+            items.clear();
+            bits.clear();
+
+            if(str == "{")
             {
-              // Connect to Power / Ground
+              // .A( {xx[1], yy [0], 1'b0} )
+              while( *(++iter) != "}" )
+              {
+                if( isSqrBracket(*iter) && !items.empty() )
+                  items.back() += *iter;
+                else
+                  items.push_back( std::move(*iter) );
+              }
+
+              // At this moment, *iter == "}"
+              isBus = true;
             }
-            else if(str == "{")
+            else
             {
-              int numBus = 0;
-              std::vector<strIter> strItrVec;
+              items.push_back(str);
+              isBus = false;
+            }
 
-              iter++;
-                
-              while( *(iter + 1) != "}" )
+            for(auto& item : items)
+            {
+              if( !getTopNets(item, bits) )
               {
-                strItrVec.push_back( ++iter );
-                numBus++;
+                parseError("Error Net ", item, " is missing in DB.");
               }
+            }
 
-              // At this moment, *(iter + 1) == "}"
-              // to skip this bracket,
-              // we have to do iter++ one more time
-              iter++;
+            int numBit = bits.size();
 
-              int curID = numBus - 1;
-              for(auto& sIter : strItrVec)
-              {
-                int netID;
-                std::string portNameWithID = portName + "[" + std::to_string(curID) + "]";
-                netName = std::move(*sIter);
+            if(numBit > 1)
+              isBus = true;
 
-                // TODO
-                // how to handle 1'b0?
-                if(netName == "1'b0" || netName == "1'b1")
-                  continue;
+            // Bits are connected from MSB
+            // .A( {xx, yy} ) -> A[1] : xx, A[0] : yy
+            for(int i = 0; i < numBit; i++)
+            {
+              int netID = bits[i];
 
-                 checkIfKeyExist(netName, strToNetID_, netID, "Net");
-  
-                int pinID = numPin_;
+              if(netID == VerilogModule::TIE0)
+                netID = getTieNetID(0);
+              else if(netID == VerilogModule::TIE1)
+                netID = getTieNetID(1);
 
-                std::string pinName = portNameWithID + ":" + cellName;
+              lefPinName = portName;
 
-                dbPin pin(pinID, cellID, netID, pinName, lefMacro->getPin(portNameWithID));
+              if(isBus)
+              {
+                lefPinName += '[';
+                lefPinName += std::to_string(numBit - 1 - i);
+                lefPinName += ']';
+              }
 
-                dbPinInsts_.push_back(pin);
-  
-                strToPinID_[pinName] = pinID;
+              const LefPin* lefPin = lefMacro->getPin(lefPinName);
 
-                numPin_++;
-                curID--;
+              if(lefPin == nullptr)
+              {
+                parseError("Error PIN ", lefPinName, " of MACRO ", macroName, " is missing in DB.");
               }
-            }
-            else
-            {  
-              int netID;
-              netName = std::move( str );
 
-              checkIfKeyExist(netName, strToNetID_, netID, "Net");
-  
               int pinID = numPin_;
-  
-              std::string pinName = portName + ":" + cellName;
 
-              dbPin pin(pinID, cellID, netID, pinName, lefMacro->getPin(portName));
+              std::string pinName = lefPinName + ":" + cellName;
+
+              dbPinInsts_.emplace_back(pinID, cellID, netID, pinName, lefPin, dbUnit_);
 
-              dbPinInsts_.push_back(pin);
-  
               strToPinID_[pinName] = pinID;
               numPin_++;
             }
@@ -1083,6 +1388,31 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
     }
   }
 
+  parse.stop();
+
+  // Submodule instances are flattened into leaf instances
+  ProfileScope flatten("flatten");
+
+  checkModuleCycle(topModule, hierInsts);
+  flattenHierInsts(hierInsts);
+
+  modules_.clear();
+  moduleMap_.clear();
+
+  flatten.stop();
+
+  // Nets aliased by "assign" are merged into one canonical net
+  ProfileScope assign("assign");
+
+  if(perCellTie_)
+    splitSharedTieNets();
+
+  collapseAssignedNets();
+
+  assign.stop();
+
+  ProfileScope fixup("fixup");
+
   dbCellPtrs_.reserve(numInst_);
   dbPinPtrs_.reserve(numPin_);
   dbNetPtrs_.reserve(numNet_);
@@ -1121,7 +1451,7 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
     {
       dbIO* ioPtr = &( dbIOInsts_[ioID] );
       ioPtr->setPin(&pin);
-      pin.setNet( netPtr );
+      pin.setIO( ioPtr );
     }
     dbPinPtrs_.push_back(&pin);
   }
@@ -1141,18 +1471,1142 @@ LefDefParser::readVerilog(const std::filesystem::path& path)
   ifReadVerilog_ = false;
 }
 
+int
+LefDefParser::findNetRoot(int netID)
+{
+  // Path Halving
+  while(netParent_[netID] != netID)
+  {
+    netParent_[netID] = netParent_[ netParent_[netID] ];
+    netID = netParent_[netID];
+  }
+  return netID;
+}
+
 void
-LefDefParser::readDefRow(strIter& itr, const strIter& end)
+LefDefParser::mergeNets(int netID1, int netID2)
 {
-  std::string rowName;
-  std::string siteName;
+  // Nets can be declared after the first assign statement,
+  // so the parent table grows lazily.
+  for(int netID = netParent_.size(); netID < numNet_; netID++)
+    netParent_.push_back(netID);
 
-  std::string rowOrient;
+  int root1 = findNetRoot(netID1);
+  int root2 = findNetRoot(netID2);
 
-  int origX = 0;
-  int origY = 0;
+  if(root1 == root2)
+    return;
 
-  int numSiteX = 0;
+  // The smaller ID always becomes the root.
+  // Since PI/PO nets are created first,
+  // the name of the port net survives after merging.
+  if(root1 < root2)
+    netParent_[root2] = root1;
+  else
+    netParent_[root1] = root2;
+}
+
+int
+LefDefParser::makeTieNet(std::string& netName)
+{
+  int netID = numNet_;
+
+  dbNet net(netID, netName);
+  net.setTie(true);
+
+  dbNetInsts_.push_back(net);
+
+  numNet_++;
+  numTieNet_++;
+
+  return netID;
+}
+
+int
+LefDefParser::getSharedTieNetID(int value)
+{
+  // Shared tie nets are made only when they are used
+  if(tieNetID_[value] == -1)
+  {
+    std::string netName = value ? "1'b1" : "1'b0";
+    tieNetID_[value] = makeTieNet(netName);
+    strToNetID_[netName] = tieNetID_[value];
+  }
+
+  return tieNetID_[value];
+}
+
+void
+LefDefParser::splitSharedTieNets()
+{
+  // Constants written on an instance already have their own stubs.
+  // A constant that reaches a cell pin through a submodule port or
+  // an assign (assign xx = 1'b0;) is on the shared tie net (or on a net merged with it).
+  auto findRoot = [&] (int netID)
+  {
+    return (netID < static_cast<int>( netParent_.size() )) ? findNetRoot(netID) : netID;
+  };
+
+  int tieRoot[2] = {-1, -1};
+
+  for(int value = 0; value < 2; value++)
+  {
+    if(tieNetID_[value] != -1)
+      tieRoot[value] = findRoot(tieNetID_[value]);
+  }
+
+  if(tieRoot[0] == -1 && tieRoot[1] == -1)
+    return;
+
+  for(auto& pin : dbPinInsts_)
+  {
+    if(pin.isExternal())
+      continue;
+
+    int root  = findRoot( pin.nid() );
+    int value = (root == tieRoot[1]) ? 1 : (root == tieRoot[0]) ? 0 : -1;
+
+    if(value == -1)
+      continue;
+
+    std::string tieName = (value ? "TIE1:" : "TIE0:") + dbCellInsts_[pin.cid()].name();
+
+    // The stub of the cell is shared with its other tie pins
+    if(auto findNet = strToNetID_.find(tieName); findNet != strToNetID_.end())
+      pin.setNid(findNet->second);
+    else
+    {
+      int netID = makeTieNet(tieName);
+      strToNetID_[tieName] = netID;
+      pin.setNid(netID);
+    }
+  }
+}
+
+void
+LefDefParser::readVerilogAssign(strIter& itr, const strIter& end)
+{
+  // assign lhs = rhs;
+  // assign {lhs1, lhs2} = {rhs1, rhs2};
+  // assign xx[3:0] = yy;
+  std::vector<std::string> lhs;
+  std::vector<std::string> rhs;
+
+  std::vector<std::string>* side = &lhs;
+
+  auto addName = [&] (std::string name)
+  {
+    if(name.empty() || name == "{" || name == "}")
+      return;
+    if(isSqrBracket(name) && !side->empty())
+      side->back() += name; // xx [3] -> xx[3]
+    else
+      side->push_back( std::move(name) );
+  };
+
+  while( itr + 1 != end && *(itr + 1) != ";" )
+  {
+    std::string& token = *(++itr);
+
+    if(auto eq = token.find('='); eq != std::string::npos)
+    {
+      addName( token.substr(0, eq) );
+      side = &rhs;
+      addName( token.substr(eq + 1) );
+    }
+    else
+      addName( std::move(token) );
+  }
+
+  if(itr + 1 == end)
+  {
+    parseError("Syntax error in assign statement.");
+  }
+
+  // Names -> NetIDs (MSB first)
+  // Undeclared names are regarded as implicit wires (same as VerilogModule::getNets)
+  auto getBits = [&] (const std::vector<std::string>& names, std::vector<int>& bits)
+  {
+    for(auto& name : names)
+    {
+      if( !getTopNets(name, bits) )
+      {
+        std::string netName = name;
+
+        dbNetInsts_.emplace_back(numNet_, netName);
+        strToNetID_[netName] = numNet_;
+
+        bits.push_back(numNet_++);
+      }
+    }
+
+    // assign xx = 1'b0; -> xx is merged into the shared tie net
+    for(auto& netID : bits)
+    {
+      if(netID == VerilogModule::TIE0)
+        netID = getSharedTieNetID(0);
+      else if(netID == VerilogModule::TIE1)
+        netID = getSharedTieNetID(1);
+    }
+  };
+
+  std::vector<int> lhsBits;
+  std::vector<int> rhsBits;
+
+  getBits(lhs, lhsBits);
+  getBits(rhs, rhsBits);
+
+  alignAssign(lhsBits, rhsBits, lhs, [&] (int netID1, int netID2) { mergeNets(netID1, netID2); });
+}
+
+void
+LefDefParser::collapseAssignedNets()
+{
+  if(netParent_.empty())
+    return;
+
+  for(int netID = netParent_.size(); netID < numNet_; netID++)
+    netParent_.push_back(netID);
+
+  std::vector<int> newID(numNet_);
+
+  int numCanonical = 0;
+
+  for(int netID = 0; netID < numNet_; netID++)
+  {
+    int root = findNetRoot(netID);
+    // root <= netID, so newID[root] is already assigned
+    newID[netID] = (root == netID) ? numCanonical++ : newID[root];
+  }
+
+  // A net merged with a tie net becomes a tie net
+  for(int netID = 0; netID < numNet_; netID++)
+  {
+    if(dbNetInsts_[netID].isTie())
+      dbNetInsts_[ findNetRoot(netID) ].setTie(true);
+  }
+
+  // Canonical nets keep their relative order,
+  // so they can be compacted in-place.
+  for(int netID = 0; netID < numNet_; netID++)
+  {
+    if(netParent_[netID] != netID)
+      continue;
+
+    int canonicalID = newID[netID];
+
+    if(canonicalID != netID)
+      dbNetInsts_[canonicalID] = std::move( dbNetInsts_[netID] );
+
+    dbNetInsts_[canonicalID].setId(canonicalID);
+  }
+
+  dbNetInsts_.resize(numCanonical);
+
+  for(auto& pin : dbPinInsts_)
+    pin.setNid( newID[pin.nid()] );
+
+  // Aliased names now point to the canonical net
+  for(auto& [netName, netID] : strToNetID_)
+    netID = newID[netID];
+
+  // Bits of bus are found by the original IDs
+  if( !strToBus_.empty() )
+    netAlias_ = std::move(newID);
+
+  numNet_ = numCanonical;
+
+  netParent_.clear();
+}
+
+// Hierarchical Verilog
+const VerilogModule::Port*
+VerilogModule::findPort(const std::string& portName) const
+{
+  auto findPort = portMap_.find(portName);
+  return (findPort == portMap_.end()) ? nullptr : &(ports_[findPort->second]);
+}
+
+int
+VerilogModule::addNet(const std::string& netName)
+{
+  if(auto findNet = netMap_.find(netName); findNet != netMap_.end())
+    return findNet->second;
+
+  int netID = netNames_.size();
+
+  netNames_.push_back(netName);
+  netMap_[netName] = netID;
+
+  return netID;
+}
+
+void
+VerilogModule::addBus(const std::string& busName, int msb, int lsb)
+{
+  if(busMap_.find(busName) != busMap_.end())
+    return;
+
+  int firstID = netNames_.size();
+  int width   = std::abs(msb - lsb) + 1;
+  int step    = (msb >= lsb) ? -1 : 1;
+
+  for(int i = 0, idx = msb; i < width; i++, idx += step)
+    netNames_.push_back( busName + "[" + std::to_string(idx) + "]" );
+
+  busMap_[busName] = std::make_tuple(firstID, msb, lsb);
+}
+
+void
+VerilogModule::addPort(const std::string& portName, PinDirection direction)
+{
+  if(portMap_.find(portName) != portMap_.end())
+    return;
+
+  Port port;
+  port.name      = portName;
+  port.direction = direction;
+  port.offset    = numPortBit_;
+
+  getNets(portName, port.bits);
+
+  numPortBit_ += port.bits.size();
+
+  portMap_[portName] = ports_.size();
+  ports_.push_back( std::move(port) );
+}
+
+void
+VerilogModule::getNets(const std::string& item, std::vector<int>& bits)
+{
+  if( getConstBits(item, bits, TIE0, TIE1) )
+    return;
+
+  std::string baseName;
+  int msb;
+  int lsb;
+
+  if( splitBitSelect(item, baseName, msb, lsb) )
+  {
+    if(auto findBus = busMap_.find(baseName); findBus != busMap_.end())
+    {
+      auto [firstID, busMsb, busLsb] = findBus->second;
+
+      int step = (msb >= lsb) ? -1 : 1;
+
+      for(int idx = msb; ; idx += step)
+      {
+        int offset = (busMsb >= busLsb) ? busMsb - idx : idx - busMsb;
+
+        if(offset < 0 || offset > std::abs(busMsb - busLsb))
+        {
+          parseError("Error - Bit ", idx, " is out of range in bus ", baseName, " of module ", name_);
+        }
+
+        bits.push_back(firstID + offset);
+
+        if(idx == lsb)
+          break;
+      }
+      return;
+    }
+  }
+  else if(auto findBus = busMap_.find(item); findBus != busMap_.end())
+  {
+    auto [firstID, busMsb, busLsb] = findBus->second;
+
+    int width = std::abs(busMsb - busLsb) + 1;
+
+    for(int i = 0; i < width; i++)
+      bits.push_back(firstID + i);
+
+    return;
+  }
+
+  // Undeclared names are regarded as implicit wires
+  bits.push_back( addNet(item) );
+}
+
+void
+VerilogModule::readDecl(strIter& itr, bool isPort, PinDirection direction)
+{
+  // input [31:0] xx, yy;
+  // output reg zz;
+  bool hasRange = false;
+  int msb = 0;
+  int lsb = 0;
+
+  while(++itr != end_ && *itr != ";")
+  {
+    if(*itr == "wire" || *itr == "reg")
+      continue;
+    else if( isSqrBracket(*itr) )
+    {
+      hasRange = parseBracketRange(*itr, msb, lsb);
+
+      if(!hasRange)
+      {
+        parseError("Bus syntax error... ", *itr);
+      }
+    }
+    else
+    {
+      if(hasRange)
+        addBus(*itr, msb, lsb);
+      else if(busMap_.find(*itr) == busMap_.end())
+        addNet(*itr);
+
+      if(isPort)
+        addPort(*itr, direction);
+    }
+  }
+}
+
+void
+VerilogModule::readAssign(strIter& itr)
+{
+  std::vector<std::string> lhs;
+  std::vector<std::string> rhs;
+
+  std::vector<std::string>* side = &lhs;
+
+  auto addName = [&] (std::string name)
+  {
+    if(name.empty() || name == "{" || name == "}")
+      return;
+    if(isSqrBracket(name) && !side->empty())
+      side->back() += name;
+    else
+      side->push_back( std::move(name) );
+  };
+
+  while(++itr != end_ && *itr != ";")
+  {
+    const std::string& token = *itr;
+
+    if(auto eq = token.find('='); eq != std::string::npos)
+    {
+      addName( token.substr(0, eq) );
+      side = &rhs;
+      addName( token.substr(eq + 1) );
+    }
+    else
+      addName(token);
+  }
+
+  std::vector<int> lhsBits;
+  std::vector<int> rhsBits;
+
+  for(auto& name : lhs)
+    getNets(name, lhsBits);
+  for(auto& name : rhs)
+    getNets(name, rhsBits);
+
+  alignAssign(lhsBits, rhsBits, lhs, [&] (int netID1, int netID2) { assigns_.emplace_back(netID1, netID2); });
+}
+
+void
+VerilogModule::readInst(strIter& itr)
+{
+  Inst inst;
+
+  inst.typeName = *itr;
+  inst.instName = *(++itr);
+
+  if(inst.instName[0] == '\\')
+    inst.instName = inst.instName.substr(1);
+
+  if(*(++itr) != "(")
+  {
+    parseError("Syntax error in instance ", inst.instName, " of module ", name_);
+  }
+
+  std::vector<std::string> items;
+
+  while(++itr != end_ && *itr != ")")
+  {
+    if((*itr)[0] != '.')
+      continue;
+
+    Conn conn;
+    bool isConcat;
+
+    conn.portName = itr->substr(1);
+
+    items.clear();
+    readNetExprItems(++itr, end_, items, isConcat);
+
+    for(auto& item : items)
+      getNets(item, conn.bits);
+
+    conn.isBus = isConcat || conn.bits.size() > 1;
+
+    if(!conn.bits.empty())
+      inst.conns.push_back( std::move(conn) );
+  }
+
+  if(itr == end_ || *(++itr) != ";")
+    std::cout << "Missing ; in instance declaration" << std::endl;
+
+  insts_.push_back( std::move(inst) );
+}
+
+void
+VerilogModule::parse()
+{
+  std::call_once(parseFlag_, [this] ()
+  {
+    strIter itr = begin_ + 1; // Module name
+
+    // Header
+    // module xx (a, b, c);
+    // module xx (input a, output [3:0] b); (ANSI-style)
+    if(*(++itr) == "(")
+    {
+      bool isAnsi = false;
+      bool hasRange = false;
+
+      int msb = 0;
+      int lsb = 0;
+
+      PinDirection direction = PinDirection::INPUT;
+
+      while(++itr != end_ && *itr != ")")
+      {
+        if(*itr == "input" || *itr == "output" || *itr == "inout")
+        {
+          isAnsi    = true;
+          hasRange  = false;
+          direction = (*itr == "input" ) ? PinDirection::INPUT 
+                    : (*itr == "output") ? PinDirection::OUTPUT 
+                                         : PinDirection::INOUT;
+        }
+        else if(*itr == "wire" || *itr == "reg")
+          continue;
+        else if( isSqrBracket(*itr) )
+          hasRange = parseBracketRange(*itr, msb, lsb);
+        else if(isAnsi)
+        {
+          if(hasRange)
+            addBus(*itr, msb, lsb);
+          else
+            addNet(*itr);
+          addPort(*itr, direction);
+        }
+      }
+
+      ++itr; // ;
+    }
+
+    // Body
+    while(++itr != end_)
+    {
+      if(*itr == "input")
+        readDecl(itr, true, PinDirection::INPUT);
+      else if(*itr == "output")
+        readDecl(itr, true, PinDirection::OUTPUT);
+      else if(*itr == "inout")
+        readDecl(itr, true, PinDirection::INOUT);
+      else if(*itr == "wire" || *itr == "reg"     || *itr == "tri" || 
+              *itr == "supply0" || *itr == "supply1")
+        readDecl(itr, false, PinDirection::INPUT);
+      else if(*itr == "assign")
+        readAssign(itr);
+      else if(*itr != ";")
+        readInst(itr);
+    }
+  });
+}
+
+VerilogModule*
+LefDefParser::findTopModule(strIter begin, const strIter& end)
+{
+  modules_.clear();
+  moduleMap_.clear();
+
+  for(auto itr = std::find(begin, end, "module"); itr != end; itr = std::find(itr, end, "module"))
+  {
+    auto endItr = std::find(itr, end, "endmodule");
+
+    if(itr + 1 == end || endItr == end)
+    {
+      parseError("No endmodule keyword in the .v file.");
+    }
+
+    std::string moduleName = *(itr + 1);
+
+    modules_.push_back( std::make_unique<VerilogModule>(moduleName, itr, endItr) );
+    moduleMap_[moduleName] = modules_.back().get();
+
+    itr = endItr;
+  }
+
+  if(modules_.empty())
+    return nullptr;
+  
+  if(modules_.size() == 1)
+    return modules_.front().get();
+
+  // The top module is not instantiated by any other module.
+  // Only the first token of each statement is checked.
+  std::unordered_set<const VerilogModule*> instantiated;
+
+  for(auto& module : modules_)
+  {
+    for(auto itr = module->begin(); itr != module->end(); ++itr)
+    {
+      if(*itr != ";")
+        continue;
+
+      if(auto findModule = moduleMap_.find( *(itr + 1) ); findModule != moduleMap_.end())
+      {
+        if(findModule->second != module.get())
+          instantiated.insert(findModule->second);
+      }
+    }
+  }
+
+  // If there are several candidates, the last one is regarded as the top
+  for(auto itr = modules_.rbegin(); itr != modules_.rend(); ++itr)
+  {
+    if(instantiated.count( itr->get() ) == 0)
+      return itr->get();
+  }
+
+  parseError("Error - No top module in the .v file (every module is instantiated by another module).");
+}
+
+bool
+LefDefParser::getTopNets(const std::string& item, std::vector<int>& bits)
+{
+  if( getConstBits(item, bits, VerilogModule::TIE0, VerilogModule::TIE1) )
+    return true;
+
+  if(auto findNet = strToNetID_.find(item); findNet != strToNetID_.end())
+  {
+    bits.push_back(findNet->second);
+    return true;
+  }
+
+  std::string baseName;
+  int msb;
+  int lsb;
+
+  bool isSelect = splitBitSelect(item, baseName, msb, lsb);
+
+  auto findBus = strToBus_.find(isSelect ? baseName : item);
+
+  if(findBus == strToBus_.end())
+    return false;
+
+  const dbBus& bus = findBus->second;
+
+  // xx -> xx[msb:lsb]
+  if(!isSelect)
+  {
+    msb = bus.msb();
+    lsb = bus.lsb();
+  }
+
+  int step = (msb >= lsb) ? -1 : 1;
+
+  for(int bit = msb; ; bit += step)
+  {
+    int offset = bus.offset(bit);
+
+    if(offset == -1)
+    {
+      parseError("Error - Bit ", bit, " is out of range in bus ", findBus->first);
+    }
+
+    bits.push_back(bus.firstNetID() + offset);
+
+    if(bit == lsb)
+      break;
+  }
+
+  return true;
+}
+
+int
+LefDefParser::findNetID(const std::string& netName) const
+{
+  if(auto findNet = strToNetID_.find(netName); findNet != strToNetID_.end())
+    return findNet->second;
+
+  std::string baseName;
+  int msb;
+  int lsb;
+
+  if( !splitBitSelect(netName, baseName, msb, lsb) || msb != lsb )
+    return -1;
+
+  auto findBus = strToBus_.find(baseName);
+
+  if(findBus == strToBus_.end() || findBus->second.offset(msb) == -1)
+    return -1;
+
+  int netID = findBus->second.firstNetID() + findBus->second.offset(msb);
+
+  return netAlias_.empty() ? netID : netAlias_[netID];
+}
+
+int
+LefDefParser::findIOID(const std::string& ioName) const
+{
+  if(auto findIO = strToIOID_.find(ioName); findIO != strToIOID_.end())
+    return findIO->second;
+
+  std::string baseName;
+  int msb;
+  int lsb;
+
+  if( !splitBitSelect(ioName, baseName, msb, lsb) || msb != lsb )
+    return -1;
+
+  auto findBus = strToBus_.find(baseName);
+
+  if(findBus == strToBus_.end() || findBus->second.firstIOID() == -1)
+    return -1;
+
+  const dbBus& bus = findBus->second;
+
+  return (bus.offset(msb) == -1) ? -1 : bus.firstIOID() + bus.offset(msb);
+}
+
+const LefMacro*
+LefDefParser::findMacro(const std::string& macroName) const
+{
+  auto findMacro = macroMap_.find(macroName);
+  return (findMacro == macroMap_.end()) ? nullptr : findMacro->second;
+}
+
+void
+LefDefParser::readHierInst(strIter& itr, const strIter& end,
+                           VerilogModule* module,
+                           std::vector<HierInst>& hierInsts)
+{
+  // Submodule is parsed at the first instantiation
+  module->parse();
+
+  HierInst hierInst;
+
+  hierInst.module   = module;
+  hierInst.instName = std::move( *(++itr) );
+  hierInst.portNets.resize(module->numPortBit(), FlatChunk::NO_NET);
+
+  if(hierInst.instName[0] == '\\')
+    hierInst.instName = hierInst.instName.substr(1);
+
+  if(++itr == end || *itr != "(")
+  {
+    parseError("Syntax error while reading Verilog.");
+  }
+
+  std::vector<std::string> items;
+  std::vector<int> bits;
+
+  while(++itr != end && *itr != ")")
+  {
+    if((*itr)[0] != '.')
+      continue;
+
+    std::string portName = itr->substr(1);
+    bool isConcat;
+
+    items.clear();
+    bits.clear();
+
+    readNetExprItems(++itr, end, items, isConcat);
+
+    for(auto& item : items)
+    {
+      if( !getTopNets(item, bits) )
+      {
+        parseError("Error Net ", item, " is missing in DB.");
+      }
+    }
+
+    for(auto& netID : bits)
+    {
+      if(netID == VerilogModule::TIE0)
+        netID = getSharedTieNetID(0);
+      else if(netID == VerilogModule::TIE1)
+        netID = getSharedTieNetID(1);
+    }
+
+    const VerilogModule::Port* port = module->findPort(portName);
+
+    if(port == nullptr)
+    {
+      std::cout << "[WARNING] Port " << portName << " is not found in module ";
+      std::cout << module->name() << std::endl;
+      continue;
+    }
+
+    // Bits are aligned from LSB
+    int numBit = std::min(port->bits.size(), bits.size());
+
+    for(int i = 1; i <= numBit; i++)
+      hierInst.portNets[port->offset + port->bits.size() - i] = bits[bits.size() - i];
+  }
+
+  if(itr == end)
+  {
+    parseError("Syntax error in gate pin-net mapping");
+  }
+
+  hierInsts.push_back( std::move(hierInst) );
+}
+
+void
+LefDefParser::flattenModule(const VerilogModule* module,
+                            const std::string& prefix,
+                            const std::vector<int>& portNets,
+                            FlatChunk& chunk) const
+{
+  // Local NetID -> Net reference of FlatChunk
+  std::vector<int> netRefs(module->numNet(), FlatChunk::NO_NET);
+
+  for(auto& port : module->ports())
+  {
+    for(size_t i = 0; i < port.bits.size(); i++)
+      netRefs[ port.bits[i] ] = portNets[port.offset + i];
+  }
+
+  // Internal nets and unconnected ports
+  for(int netID = 0; netID < module->numNet(); netID++)
+  {
+    if(netRefs[netID] != FlatChunk::NO_NET)
+      continue;
+
+    std::string netName = prefix + module->netName(netID);
+
+    chunk.nets.emplace_back(chunk.nets.size(), netName);
+    netRefs[netID] = -static_cast<int>( chunk.nets.size() );
+  }
+
+  auto toRef = [&] (int netID)
+  {
+    if(netID == VerilogModule::TIE0)
+      return FlatChunk::TIE0;
+    else if(netID == VerilogModule::TIE1)
+      return FlatChunk::TIE1;
+    else
+      return netRefs[netID];
+  };
+
+  for(auto& [netID1, netID2] : module->assigns())
+    chunk.assigns.emplace_back( toRef(netID1), toRef(netID2) );
+
+  for(auto& inst : module->insts())
+  {
+    std::string instName = prefix + inst.instName;
+
+    if(auto findMacro = macroMap_.find(inst.typeName); findMacro != macroMap_.end())
+    {
+      LefMacro* lefMacro = findMacro->second;
+
+      int cellID = chunk.cells.size();
+
+      chunk.cells.emplace_back(cellID, instName, lefMacro);
+
+      dbCell& cell = chunk.cells.back();
+
+      cell.setDx( static_cast<int>( lefMacro->sizeX() * static_cast<float>(dbUnit_) ) );
+      cell.setDy( static_cast<int>( lefMacro->sizeY() * static_cast<float>(dbUnit_) ) );
+
+      if( lefMacro->macroClass() == MacroClass::BLOCK)
+        chunk.numMacro++;
+      else if( lefMacro->macroClass() == MacroClass::CORE)
+        chunk.numStdCell++;
+
+      // Tie stubs of this instance (only for per-cell tie mode)
+      int cellTieRef[2] = {FlatChunk::NO_NET, FlatChunk::NO_NET};
+
+      for(auto& conn : inst.conns)
+      {
+        int numBit = conn.bits.size();
+
+        for(int i = 0; i < numBit; i++)
+        {
+          int netID = conn.bits[i];
+          int netRef;
+
+          if(perCellTie_ && (netID == VerilogModule::TIE0 || netID == VerilogModule::TIE1))
+          {
+            int value = (netID == VerilogModule::TIE1) ? 1 : 0;
+
+            if(cellTieRef[value] == FlatChunk::NO_NET)
+            {
+              std::string tieName = (value ? "TIE1:" : "TIE0:") + instName;
+
+              chunk.nets.emplace_back(chunk.nets.size(), tieName);
+              chunk.nets.back().setTie(true);
+              chunk.numTieNet++;
+
+              cellTieRef[value] = -static_cast<int>( chunk.nets.size() );
+            }
+
+            netRef = cellTieRef[value];
+          }
+          else
+            netRef = toRef(netID);
+
+          std::string portName = conn.isBus 
+                               ? conn.portName + "[" + std::to_string(numBit - 1 - i) + "]" 
+                               : conn.portName;
+
+          const LefPin* lefPin = lefMacro->getPin(portName);
+
+          if(lefPin == nullptr)
+          {
+            parseError("Error PIN ", portName, " of MACRO ", lefMacro->name(), " is missing in DB.");
+          }
+
+          std::string pinName = portName + ":" + instName;
+
+          chunk.pins.emplace_back(chunk.pins.size(), cellID, netRef, pinName, lefPin, dbUnit_);
+        }
+      }
+    }
+    else if(auto findModule = moduleMap_.find(inst.typeName); findModule != moduleMap_.end())
+    {
+      VerilogModule* subModule = findModule->second;
+
+      // Submodule is parsed at the first instantiation
+      subModule->parse();
+
+      std::vector<int> subPortNets(subModule->numPortBit(), FlatChunk::NO_NET);
+
+      for(auto& conn : inst.conns)
+      {
+        const VerilogModule::Port* port = subModule->findPort(conn.portName);
+
+        if(port == nullptr)
+        {
+          std::cout << "[WARNING] Port " << conn.portName << " is not found in module ";
+          std::cout << subModule->name() << std::endl;
+          continue;
+        }
+
+        // Bits are aligned from LSB
+        int numBit = std::min(port->bits.size(), conn.bits.size());
+
+        for(int i = 1; i <= numBit; i++)
+        {
+          subPortNets[port->offset + port->bits.size() - i] 
+            = toRef( conn.bits[conn.bits.size() - i] );
+        }
+      }
+
+      flattenModule(subModule, instName + "/", subPortNets, chunk);
+    }
+    else
+    {
+      parseError("Error MACRO ", inst.typeName, " is missing in DB.");
+    }
+  }
+}
+
+void
+LefDefParser::mergeFlatChunk(FlatChunk& chunk)
+{
+  // Shared tie nets have to be made before the offsets are fixed
+  auto checkTie = [&] (int netRef)
+  {
+    if(netRef == FlatChunk::TIE0)
+      getSharedTieNetID(0);
+    else if(netRef == FlatChunk::TIE1)
+      getSharedTieNetID(1);
+  };
+
+  for(auto& pin : chunk.pins)
+    checkTie( pin.nid() );
+
+  for(auto& [netRef1, netRef2] : chunk.assigns)
+  {
+    checkTie(netRef1);
+    checkTie(netRef2);
+  }
+
+  int cellOffset = numInst_;
+  int pinOffset  = numPin_;
+  int netOffset  = numNet_;
+
+  auto toNetID = [&] (int netRef)
+  {
+    if(netRef >= 0)
+      return netRef;
+    else if(netRef == FlatChunk::TIE0)
+      return tieNetID_[0];
+    else if(netRef == FlatChunk::TIE1)
+      return tieNetID_[1];
+    else
+      return netOffset - netRef - 1;
+  };
+
+  for(auto& net : chunk.nets)
+  {
+    net.setId( net.id() + netOffset );
+    strToNetID_[net.name()] = net.id();
+    dbNetInsts_.push_back( std::move(net) );
+  }
+
+  for(auto& cell : chunk.cells)
+  {
+    cell.setId( cell.id() + cellOffset );
+    strToCellID_[cell.name()] = cell.id();
+    dbCellInsts_.push_back( std::move(cell) );
+  }
+
+  for(auto& pin : chunk.pins)
+  {
+    pin.setId ( pin.id()  + pinOffset  );
+    pin.setCid( pin.cid() + cellOffset );
+    pin.setNid( toNetID( pin.nid() )   );
+    strToPinID_[pin.name()] = pin.id();
+    dbPinInsts_.push_back( std::move(pin) );
+  }
+
+  numInst_    += chunk.cells.size();
+  numPin_     += chunk.pins.size();
+  numNet_     += chunk.nets.size();
+  numStdCell_ += chunk.numStdCell;
+  numMacro_   += chunk.numMacro;
+  numTieNet_  += chunk.numTieNet;
+
+  for(auto& [netRef1, netRef2] : chunk.assigns)
+    mergeNets( toNetID(netRef1), toNetID(netRef2) );
+
+  chunk = FlatChunk();
+}
+
+void
+LefDefParser::checkModuleCycle(const VerilogModule* topModule,
+                               const std::vector<HierInst>& hierInsts) const
+{
+  // 1 : on the current path, 2 : done (no cycle below)
+  std::unordered_map<const VerilogModule*, int> state;
+
+  // The top module is on every path (it is read without VerilogModule::parse)
+  state[topModule] = 1;
+
+  // (module, next instance to visit)
+  std::vector<std::pair<VerilogModule*, size_t>> path;
+
+  auto cycleError = [&] (const VerilogModule* module)
+  {
+    // From the first visit of the module on the path
+    bool isOnCycle = (module == topModule);
+
+    std::string cycle = isOnCycle ? topModule->name() : "";
+
+    for(auto& [pathModule, next] : path)
+    {
+      isOnCycle |= (pathModule == module);
+
+      if(isOnCycle)
+        cycle += (cycle.empty() ? "" : " -> ") + pathModule->name();
+    }
+
+    cycle += " -> " + module->name();
+
+    parseError("Error - Cyclic module instantiation : ", cycle);
+  };
+
+  for(const HierInst& hierInst : hierInsts)
+  {
+    VerilogModule* root = hierInst.module;
+
+    if(int& rootState = state[root]; rootState == 2)
+      continue;
+    else if(rootState == 1)
+      cycleError(root);
+    else
+      rootState = 1;
+
+    root->parse();
+    path.emplace_back(root, 0);
+
+    while(!path.empty())
+    {
+      VerilogModule* module = path.back().first;
+      size_t&        next   = path.back().second;
+
+      if(next == module->insts().size())
+      {
+        state[module] = 2;
+        path.pop_back();
+        continue;
+      }
+
+      const std::string& typeName = module->insts()[next++].typeName;
+
+      // LEF MACRO comes first (as in flattenModule)
+      if(macroMap_.count(typeName) != 0)
+        continue;
+
+      auto findModule = moduleMap_.find(typeName);
+
+      if(findModule == moduleMap_.end())
+        continue;
+
+      VerilogModule* subModule = findModule->second;
+
+      int& subState = state[subModule];
+
+      if(subState == 1)
+        cycleError(subModule);
+      else if(subState == 0)
+      {
+        subState = 1;
+        subModule->parse();
+        path.emplace_back(subModule, 0);
+      }
+    }
+  }
+}
+
+void
+LefDefParser::flattenHierInsts(std::vector<HierInst>& hierInsts)
+{
+  if(hierInsts.empty())
+    return;
+
+  int numHierInst = hierInsts.size();
+  int numThreads  = std::max(1, std::min(numThreads_, numHierInst));
+
+  std::cout << "  Flatten " << numHierInst << " module instances";
+  std::cout << " with " << numThreads << " threads..." << std::endl;
+
+  // Each top-level instance is flattened into its own chunk,
+  // and the chunks are merged in order (deterministic IDs).
+  std::vector<FlatChunk> chunks(numHierInst);
+
+  // The first error of the workers is thrown again after the join
+  runQueue(numThreads, numHierInst, [&] (int i)
+  {
+    const HierInst& hierInst = hierInsts[i];
+    flattenModule(hierInst.module, hierInst.instName + "/", hierInst.portNets, chunks[i]);
+  });
+
+  for(auto& chunk : chunks)
+    mergeFlatChunk(chunk);
+}
+
+void
+LefDefParser::readDefRow(strIter& itr, const strIter& end)
+{
+  std::string rowName;
+  std::string siteName;
+
+  std::string rowOrient;
+
+  int origX = 0;
+  int origY = 0;
+
+  int numSiteX = 0;
   int numSiteY = 0;
 
   int stepX = 0;
@@ -1169,21 +2623,21 @@ LefDefParser::readDefRow(strIter& itr, const strIter& end)
   // These stupid assert functions are
   // just for temporary implementations...
   // they will be replaced soon...
-  assert( *(++itr) == "DO" );
+  expectToken(*(++itr), "DO");
 
   numSiteX = std::stoi( *(++itr) );
 
-  assert( *(++itr) == "BY" );
+  expectToken(*(++itr), "BY");
 
   numSiteY = std::stoi( *(++itr) );
 
-  assert( *(++itr) == "STEP" );
+  expectToken(*(++itr), "STEP");
 
   stepX = std::stoi( *(++itr) );
 
   stepY = std::stoi( *(++itr) );
 
-  assert( *(++itr) == ";" );
+  expectToken(*(++itr), ";");
 
   LefSite* lefSite;
 
@@ -1222,21 +2676,20 @@ LefDefParser::readDefDie(strIter& itr, const strIter& end)
     {
       lx = std::stoi(*(++itr));
       ly = std::stoi(*(++itr));
-      assert( *(++itr) == ")" );
-      assert( *(++itr) == "(" );
+      expectToken(*(++itr), ")");
+      expectToken(*(++itr), "(");
       ux = std::stoi(*(++itr));
       uy = std::stoi(*(++itr));
-      assert( *(++itr) == ")" );
+      expectToken(*(++itr), ")");
       break;
     }
   }
 
-  assert( *(++itr) == ";" );
+  expectToken(*(++itr), ";");
 
   if(itr == end)
   {
-    std::cout << "Syntax Error in DEF." << std::endl;
-    exit(0);
+    parseError("Syntax Error in DEF.");
   }
 
   die_.setCoordi(lx, ly, ux, uy);
@@ -1277,10 +2730,10 @@ LefDefParser::readDefOneComponent(strIter& itr, const strIter& end)
       {
         cellStatus = std::move( *itr );
 
-        assert( *(++itr) == "(" );
+        expectToken(*(++itr), "(");
         lx = std::stoi( std::move( *(++itr) ) );
         ly = std::stoi( std::move( *(++itr) ) );
-        assert( *(++itr) == ")" );
+        expectToken(*(++itr), ")");
 
         cellOrient = std::move( *(++itr) );
       }
@@ -1323,11 +2776,16 @@ LefDefParser::readDefOneComponent(strIter& itr, const strIter& end)
     // I don't know why...
     cellID = numInst_;
 
-    dbCell newCell(cellID, instName, lefMacro);
+    // dbCellInsts_ would move every cell when it grows
+    dbDummyInsts_.emplace_back(cellID, instName, lefMacro);
 
-    dbCellInsts_.push_back(newCell);
+    cell = &dbDummyInsts_.back();
+    cell->setDummy(true);
+    cell->setDx( static_cast<int>( lefMacro->sizeX() * static_cast<float>(dbUnit_) ) );
+    cell->setDy( static_cast<int>( lefMacro->sizeY() * static_cast<float>(dbUnit_) ) );
 
-    cell = &newCell;
+    dbCellPtrs_.push_back(cell);
+    strToCellID_[instName] = cellID;
 
     if( lefMacro->macroClass() == MacroClass::BLOCK)
       numMacro_++;
@@ -1350,14 +2808,13 @@ LefDefParser::readDefOneComponent(strIter& itr, const strIter& end)
 
     if(orientCheck == strToOrient_.end())
     {
-      std::cout << "Error - COMPONENT ORIENT " << cellOrient;
-      std::cout << " is not supported yet." << std::endl;
-      exit(0);
+      parseError("Error - COMPONENT ORIENT ", cellOrient, " is not supported yet.");
     }
     else
       orient = orientCheck->second;
 
     cell->setOrient(orient);
+    cell->setFixed(isFixed);
 
     cell->setLx(lx);
     cell->setLy(ly);
@@ -1380,7 +2837,7 @@ LefDefParser::readDefComponents(strIter& itr, const strIter& end)
 {
   int defComponents = std::stoi( std::move( *(++itr) ) );
 
-  assert( *(++itr) == ";" );
+  expectToken(*(++itr), ";");
 
   while(++itr != end)
   {
@@ -1390,13 +2847,87 @@ LefDefParser::readDefComponents(strIter& itr, const strIter& end)
       break;
     else
     {
-      std::cout << *itr << std::endl;
-      std::cout << "Syntax Error while Reading DEF COMPONENTS" << std::endl;
-      exit(0);
+      parseError("Syntax Error while Reading DEF COMPONENTS : ", *itr);
     }
   }
 }
 
+Status
+LefDefParser::readDefComponents(std::vector<std::string>& tokens)
+{
+  if(!ifReadDef_)
+    return Status::error("Error - Please read DEF first!");
+
+  // Positions and counts before the call (restored on failure)
+  const int numCell = dbCellPtrs_.size();
+
+  dbPlacement before;
+
+  before.lx.resize(numCell);
+  before.ly.resize(numCell);
+  before.orient.resize(numCell);
+  before.isFixed.resize(numCell);
+
+  for(int i = 0; i < numCell; i++)
+  {
+    const dbCell* cell = dbCellPtrs_[i];
+    before.lx[i]      = cell->lx();
+    before.ly[i]      = cell->ly();
+    before.orient[i]  = cell->orient();
+    before.isFixed[i] = cell->isFixed();
+  }
+
+  const int numInst     = numInst_;
+  const int numStdCell  = numStdCell_;
+  const int numMacro    = numMacro_;
+  const int numDummy    = numDummy_;
+  const int numDefComps = numDefComps_;
+
+  auto load = [&] ()
+  {
+    auto itr = tokens.begin();
+    auto end = tokens.end();
+
+    if(itr == end || *itr != "COMPONENTS")
+    {
+      parseError("Error - DEF tokens do not start with COMPONENTS.");
+    }
+
+    numDefComps_ = 0;
+
+    readDefComponents(itr, end);
+
+    // Dummy cells of a new component would not be in the statistics of the DEF
+    if(static_cast<int>( dbCellPtrs_.size() ) != numCell)
+    {
+      parseError("Error - COMPONENT ", dbCellPtrs_.back()->name(), " is not in the DB.");
+    }
+
+    updatePinLocations();
+  };
+
+  auto rollback = [&] ()
+  {
+    for(size_t i = numCell; i < dbCellPtrs_.size(); i++)
+    {
+      strToCellID_.erase( dbCellPtrs_[i]->name() );
+      dbDummyInsts_.pop_back();
+    }
+
+    dbCellPtrs_.resize(numCell);
+
+    numInst_     = numInst;
+    numStdCell_  = numStdCell;
+    numMacro_    = numMacro;
+    numDummy_    = numDummy;
+    numDefComps_ = numDefComps;
+
+    (void)applyPlacement(before);
+  };
+
+  return runLoad("COMPONENTS tokens", load, rollback);
+}
+
 void 
 LefDefParser::readDefOnePin(strIter& itr, const strIter& end)
 {
@@ -1419,9 +2950,9 @@ LefDefParser::readDefOnePin(strIter& itr, const strIter& end)
 
   pinName = std::move( *(++itr) );
 
-  assert( *(++itr) == "+" );
+  expectToken(*(++itr), "+");
 
-  assert( *(++itr) == "NET" );
+  expectToken(*(++itr), "NET");
 
   netName = std::move( *(++itr) );
 
@@ -1434,13 +2965,13 @@ LefDefParser::readDefOnePin(strIter& itr, const strIter& end)
     {
       pinStatus = std::move( *(itr) );
 
-      assert(*(++itr) == "(");
+      expectToken(*(++itr), "(");
 
       originX = std::stoi( *(++itr) );
 
       originY = std::stoi( *(++itr) );
 
-      assert(*(++itr) == ")");
+      expectToken(*(++itr), ")");
 
       pinOrient = std::move( *(++itr) );
     }
@@ -1449,21 +2980,21 @@ LefDefParser::readDefOnePin(strIter& itr, const strIter& end)
     {
       pinLayer = std::move( *(++itr) );
 
-      assert(*(++itr) == "(");
+      expectToken(*(++itr), "(");
 
       offsetX1 = std::stoi( *(++itr) );
 
       offsetY1 = std::stoi( *(++itr) );
 
-      assert(*(++itr) == ")");
+      expectToken(*(++itr), ")");
 
-      assert(*(++itr) == "(");
+      expectToken(*(++itr), "(");
 
       offsetX2 = std::stoi( *(++itr) );
 
       offsetY2 = std::stoi( *(++itr) );
 
-      assert(*(++itr) == ")");
+      expectToken(*(++itr), ")");
     }
     else
       itr++;
@@ -1525,8 +3056,9 @@ LefDefParser::readDefOnePin(strIter& itr, const strIter& end)
     ly = originY - dy / 2;
   }
 
-  bool ifKeyExist;
-  checkIfKeyExist(pinName, strToIOID_, ioID, "PIN", ifKeyExist);
+  ioID = findIOID(pinName);
+
+  bool ifKeyExist = (ioID != -1);
 
   if(!ifReadVerilog_ && !ifKeyExist)
   {
@@ -1535,9 +3067,7 @@ LefDefParser::readDefOnePin(strIter& itr, const strIter& end)
   }
   else if(ifReadVerilog_ && !ifKeyExist)
   {
-    std::cout << "Error PIN ";
-    std::cout << pinName << " is missing in DB." << std::endl;
-    exit(0);
+    parseError("Error PIN ", pinName, " is missing in DB.");
   }
   else if(ifKeyExist)
   {
@@ -1554,7 +3084,7 @@ LefDefParser::readDefPins(strIter& itr, const strIter& end)
 {
   int numDefPins = std::stoi( *(++itr) );
 
-  assert( *(++itr) == ";" );
+  expectToken(*(++itr), ";");
 
   while(++itr != end)
   {
@@ -1564,28 +3094,130 @@ LefDefParser::readDefPins(strIter& itr, const strIter& end)
       break;
     else
     {
-      std::cout << "Syntax Error while Reading DEF PINS" << std::endl;
-      std::cout << *(itr) << std::endl;
-      exit(0);
+      parseError("Syntax Error while Reading DEF PINS : ", *itr);
     }
   }
 }
 
-void 
-LefDefParser::readDef(const std::filesystem::path& fileName)
+Status
+LefDefParser::readDef(const std::filesystem::path& path)
 {
-  std::cout << "Read " << std::string(fileName) << std::endl;
-
   if(!ifReadLef_)
+    return Status::error("Error - Please read LEF first!");
+
+  if(ifReadDef_)
+    return Status::error("Error - DEF is already loaded.");
+
+  saveDefBase();
+
+  return runLoad(path, [&] () { readDefFile(path); }, [&] () { restoreDefBase(); });
+}
+
+Status
+LefDefParser::unloadDef()
+{
+  if(!ifReadDef_)
+    return Status::error("Error - DEF is not loaded.");
+
+  restoreDefBase();
+
+  return Status();
+}
+
+void
+LefDefParser::saveDefBase()
+{
+  dbPlacement& placement = defBase_.placement;
+
+  int numCell = dbCellInsts_.size();
+
+  placement.lx.resize(numCell);
+  placement.ly.resize(numCell);
+  placement.orient.resize(numCell);
+  placement.isFixed.resize(numCell);
+
+  for(int i = 0; i < numCell; i++)
   {
-    std::cout << "Error - Please read LEF first!" << std::endl;
-    exit(0);
+    const dbCell& cell = dbCellInsts_[i];
+    placement.lx[i]      = cell.lx();
+    placement.ly[i]      = cell.ly();
+    placement.orient[i]  = cell.orient();
+    placement.isFixed[i] = cell.isFixed();
   }
 
-  static std::string_view delimiters = "#";
-  static std::string_view exceptions = "";
-  
-  auto tokens = tokenize(fileName, delimiters, exceptions);
+  defBase_.ios        = dbIOInsts_;
+  defBase_.die        = die_;
+
+  defBase_.numCell    = numCell;
+  defBase_.numInst    = numInst_;
+  defBase_.numStdCell = numStdCell_;
+  defBase_.numMacro   = numMacro_;
+  defBase_.numDummy   = numDummy_;
+}
+
+void
+LefDefParser::restoreDefBase()
+{
+  const dbPlacement& placement = defBase_.placement;
+
+  int numCell = defBase_.numCell;
+
+  // Dummy cells of DEF
+  for(const dbCell& dummy : dbDummyInsts_)
+    strToCellID_.erase(dummy.name());
+
+  dbDummyInsts_.clear();
+  dbCellPtrs_.resize(numCell);
+
+  for(int i = 0; i < numCell; i++)
+  {
+    dbCell& cell = dbCellInsts_[i];
+    cell.setLx( placement.lx[i] );
+    cell.setLy( placement.ly[i] );
+    cell.setOrient( placement.orient[i] );
+    cell.setFixed( placement.isFixed[i] );
+  }
+
+  std::copy(defBase_.ios.begin(), defBase_.ios.end(), dbIOInsts_.begin());
+
+  // dbIO::setLocation of DEF also moved the pins of the IOs
+  for(dbIO& io : dbIOInsts_)
+  {
+    if(io.pin() != nullptr)
+      io.setLocation(io.lx(), io.ly(), io.ux() - io.lx(), io.uy() - io.ly());
+  }
+
+  die_        = defBase_.die;
+
+  numInst_    = defBase_.numInst;
+  numStdCell_ = defBase_.numStdCell;
+  numMacro_   = defBase_.numMacro;
+  numDummy_   = defBase_.numDummy;
+
+  numRow_      = 0;
+  numDefComps_ = 0;
+
+  dbRowInsts_.clear();
+  dbRowPtrs_.clear();
+
+  sumTotalInstArea_ = 0;
+  sumStdCellArea_   = 0;
+  sumMacroArea_     = 0;
+
+  util_    = 0.0;
+  density_ = 0.0;
+
+  updatePinLocations();
+
+  ifReadDef_ = false;
+}
+
+void 
+LefDefParser::readDefFile(const std::filesystem::path& fileName)
+{
+  std::cout << "Read " << std::string(fileName) << std::endl;
+
+  auto tokens = tokenize(fileName, defDelimiters_, defExceptions_);
 
   auto itr = tokens.begin();
   auto end = tokens.end();
@@ -1597,6 +3229,8 @@ LefDefParser::readDef(const std::filesystem::path& fileName)
   int numRow       = 0;
   int numNet       = 0;
 
+  ProfileScope parse("parse");
+
   while(++itr != end) 
   {
     if(*itr == "DESIGN")
@@ -1619,6 +3253,10 @@ LefDefParser::readDef(const std::filesystem::path& fileName)
       break;
   }
 
+  parse.stop();
+
+  ProfileScope fixup("fixup");
+
   // Make Row Ptrs
   int coreLx = INT_MAX;
   int coreLy = INT_MAX;
@@ -1657,6 +3295,12 @@ LefDefParser::readDef(const std::filesystem::path& fileName)
 
   die_.setCoreCoordi(coreLx, coreLy, coreUx, coreUy);
 
+  updatePinLocations();
+
+  fixup.stop();
+
+  ProfileScope stats("stats");
+
   for(auto& cell : dbCellPtrs_)
   {
     int64_t area = cell->area();
@@ -1690,8 +3334,307 @@ LefDefParser::readDef(const std::filesystem::path& fileName)
   ifReadDef_ = true;
 }
 
+Status
+LefDefParser::readDefPlacement(const std::filesystem::path& path, 
+                               dbPlacement& placement) const
+{
+  if(!ifReadDef_)
+    return Status::error("Error - Please read DEF first!");
+
+  // Only the snapshot is written (nothing to roll back in the DB)
+  return runLoad(path, [&] () { readDefPlacementFile(path, placement); }, [] () {});
+}
+
+void
+LefDefParser::readDefPlacementFile(const std::filesystem::path& fileName, 
+                                   dbPlacement& placement) const
+{
+  std::ifstream ifs(fileName, std::ios::ate);
+
+  if(!ifs.good())
+  {
+    parseError("Error - Failed to open ", std::string(fileName));
+  }
+
+  size_t fsize = ifs.tellg();
+  ifs.seekg(0, std::ios::beg);
+  std::vector<char> buffer(fsize);
+  ifs.read(buffer.data(), fsize);
+
+  // Start from the current positions
+  // (UNPLACED or missing COMPONENTS keep their locations)
+  int numCell = dbCellPtrs_.size();
+
+  placement.lx.resize(numCell);
+  placement.ly.resize(numCell);
+  placement.orient.resize(numCell);
+  placement.isFixed.resize(numCell);
+  placement.numPlaced = 0;
+
+  for(int i = 0; i < numCell; i++)
+  {
+    const dbCell* cell = dbCellPtrs_[i];
+    placement.lx[i]      = cell->lx();
+    placement.ly[i]      = cell->ly();
+    placement.orient[i]  = cell->orient();
+    placement.isFixed[i] = cell->isFixed();
+  }
+
+  // Tokens are scanned in place (no token list)
+  // since only COMPONENTS are needed.
+  const char* pos = buffer.data();
+  const char* end = buffer.data() + fsize;
+
+  // Space, tab, newline, ... (faster than std::isspace)
+  auto isSpace = [] (char c) { return static_cast<unsigned char>(c) <= ' '; };
+
+  auto next = [&] () -> std::string_view
+  {
+    while(pos != end)
+    {
+      if(*pos == '#')
+      {
+        while(pos != end && *pos != '\n')
+          pos++;
+      }
+      else if(isSpace(*pos))
+        pos++;
+      else
+        break;
+    }
+
+    const char* begin = pos;
+
+    while(pos != end && !isSpace(*pos))
+      pos++;
+
+    return std::string_view(begin, pos - begin);
+  };
+
+  auto toInt = [&] (std::string_view token)
+  {
+    int value = 0;
+    bool minus = (!token.empty() && token[0] == '-');
+
+    for(size_t i = minus ? 1 : 0; i < token.size(); i++)
+    {
+      if(token[i] < '0' || token[i] > '9')
+      {
+        parseError("Error - Invalid coordinate ", token, " in ", std::string(fileName));
+      }
+      value = value * 10 + (token[i] - '0');
+    }
+
+    return minus ? -value : value;
+  };
+
+  std::string_view token;
+
+  while( !(token = next()).empty() && token != "COMPONENTS" ) {}
+
+  if(token.empty())
+  {
+    parseError("Error - No COMPONENTS in ", std::string(fileName));
+  }
+
+  next(); // Number of COMPONENTS
+  next(); // ;
+
+  // Reused for the hash look-up (no allocation per component)
+  std::string instName;
+  std::string cellOrient;
+
+  int numComp = 0;
+
+  while( !(token = next()).empty() )
+  {
+    if(token == "END")
+      break;
+
+    if(token != "-")
+    {
+      parseError("Syntax Error while Reading DEF COMPONENTS : ", token);
+    }
+
+    instName.clear();
+
+    // Innovus saveNetlist -flat inserts '\' (same as readDefOneComponent)
+    for(char c : next())
+    {
+      if(c != '\\')
+        instName.push_back(c);
+    }
+
+    next(); // Macro Name
+
+    bool isPlaced = false;
+    bool isFixed  = false;
+
+    int lx = 0;
+    int ly = 0;
+
+    while( !(token = next()).empty() && token != ";" )
+    {
+      if(token == "PLACED" || token == "FIXED")
+      {
+        isPlaced = true;
+        isFixed  = (token == "FIXED");
+
+        next(); // (
+        lx = toInt( next() );
+        ly = toInt( next() );
+        next(); // )
+
+        cellOrient.assign( next() );
+      }
+    }
+
+    // DEFs of a trajectory list COMPONENTS in the same order,
+    // so the cell of the previous DEF is checked before the hash table
+    // (a string compare on contiguous cells instead of a random access)
+    int cellID = -1;
+    int compID = numComp++;
+
+    // No previous DEF : guess the order of the DB
+    if(compID == static_cast<int>( placement.order.size() ))
+      placement.order.push_back(compID < numCell ? compID : -1);
+
+    int hint = placement.order[compID];
+
+    if(hint >= 0 && dbCellPtrs_[hint]->name() == instName)
+      cellID = hint;
+
+    if(cellID == -1)
+    {
+      auto checkCell = strToCellID_.find(instName);
+
+      // Dummy cells of the first DEF are in the DB too,
+      // so only the components new to this DEF are skipped
+      if(checkCell != strToCellID_.end())
+        cellID = checkCell->second;
+    }
+
+    placement.order[compID] = cellID;
+
+    if(!isPlaced || cellID == -1)
+      continue;
+
+    auto orientCheck = strToOrient_.find(cellOrient);
+
+    if(orientCheck == strToOrient_.end())
+    {
+      parseError("Error - COMPONENT ORIENT ", cellOrient, " is not supported yet.");
+    }
+
+    placement.lx[cellID]      = lx;
+    placement.ly[cellID]      = ly;
+    placement.orient[cellID]  = orientCheck->second;
+    placement.isFixed[cellID] = isFixed;
+    placement.numPlaced++;
+  }
+}
+
+Status
+LefDefParser::applyPlacement(const dbPlacement& placement)
+{
+  if(placement.lx.size() != dbCellPtrs_.size())
+    return Status::error("Error - Placement does not match the design.");
+
+  const int numCell = dbCellPtrs_.size();
+
+  for(int i = 0; i < numCell; i++)
+  {
+    dbCell* cell = dbCellPtrs_[i];
+    cell->setLx( placement.lx[i] );
+    cell->setLy( placement.ly[i] );
+    cell->setOrient( placement.orient[i] );
+    cell->setFixed( placement.isFixed[i] );
+  }
+
+  updatePinLocations();
+
+  return Status();
+}
+
+// Offset of the pin center from the lower-left of a cell of size (dx, dy)
+// LEF pin shapes are relative to the macro ORIGIN (origin is the lower-left when placed)
+// S : rotated by 180, FN : mirrored about the Y axis, FS : mirrored about the X axis
+inline void orientOffset(Orient orient, int dx, int dy, int& ox, int& oy)
+{
+  switch(orient)
+  {
+    case Orient::S  : ox = dx - ox; oy = dy - oy; break;
+    case Orient::FN : ox = dx - ox;               break;
+    case Orient::FS :               oy = dy - oy; break;
+    default         :                             break; // N (W, E, FW, FE are not supported for cells)
+  }
+}
+
 void
-LefDefParser::printInfo()
+LefDefParser::pinOffset(const dbPin* pin, int& ox, int& oy) const
+{
+  const dbCell*   cell  = pin->cell();
+  const LefMacro* macro = cell->lefMacro();
+
+  ox = pin->offsetX() + static_cast<int>( macro->origX() * dbUnit_ );
+  oy = pin->offsetY() + static_cast<int>( macro->origY() * dbUnit_ );
+
+  orientOffset(cell->orient(), cell->dx(), cell->dy(), ox, oy);
+}
+
+void
+LefDefParser::moveCell(int cellID, int lx, int ly)
+{
+  dbCell* cell = dbCellPtrs_[cellID];
+
+  cell->setLx(lx);
+  cell->setLy(ly);
+
+  for(dbPin* pin : cell->pins())
+  {
+    int ox, oy;
+    pinOffset(pin, ox, oy);
+
+    pin->setCx(lx + ox);
+    pin->setCy(ly + oy);
+  }
+}
+
+void
+LefDefParser::updatePinLocations()
+{
+  ProfileScope scope("pins");
+
+  const int numCell    = dbCellPtrs_.size();
+  const int numThreads = std::max(1, std::min(numThreads_, numCell / 4096));
+
+  // Each pin belongs to one cell, so the chunks of cells write disjoint pins
+  runChunks(numThreads, numCell, [&] (int t, int begin, int end)
+  {
+    for(int i = begin; i < end; i++)
+    {
+      const dbCell*   cell  = dbCellPtrs_[i];
+      const LefMacro* macro = cell->lefMacro();
+
+      const int origX = static_cast<int>( macro->origX() * dbUnit_ );
+      const int origY = static_cast<int>( macro->origY() * dbUnit_ );
+
+      for(dbPin* pin : cell->pins())
+      {
+        int ox = pin->offsetX() + origX;
+        int oy = pin->offsetY() + origY;
+
+        orientOffset(cell->orient(), cell->dx(), cell->dy(), ox, oy);
+
+        pin->setCx(cell->lx() + ox);
+        pin->setCy(cell->ly() + oy);
+      }
+    }
+  });
+}
+
+void
+LefDefParser::printInfo(std::ostream& os) const
 {
   int dieLx = die_.lx();
   int dieLy = die_.ly();
@@ -1704,42 +3647,51 @@ LefDefParser::printInfo()
   int coreUy = die_.coreUy();
 
   using namespace std;
-  cout << endl;
-  cout << "*** Summary of Information ***" << endl;
-  cout << "---------------------------------------------" << endl;
-  cout << " TECHNOLOGY INFO"                           << endl;
-  cout << "---------------------------------------------" << endl;
-  cout << " NUM LEF MACRO    : " << macros_.size() << endl;
-  cout << " NUM LEF SITE     : " << sites_.size()  << endl;
-  cout << " DATABASE UNIT    : " << dbUnit_ << endl;
-  cout << "---------------------------------------------" << endl;
-  cout << " DESIGN INFO"                               << endl;
-  cout << "---------------------------------------------" << endl;
-  cout << " DESIGN NAME      : " << designName_ << endl;
-  cout << " NUM PI           : " << numPI_      << endl;
-  cout << " NUM PO           : " << numPO_      << endl;
-  cout << " NUM IO           : " << numIO_      << endl;
-  cout << " NUM INSTANCE     : " << numInst_    << endl;
-  cout << " NUM MACRO        : " << numMacro_   << endl;
-  cout << " NUM STD CELL     : " << numStdCell_ << endl;
-  cout << " NUM NET          : " << numNet_     << endl;
-  cout << " NUM PIN          : " << numPin_     << endl;
-  cout << " NUM DUMMY        : " << numDummy_   << endl;
-  cout << " NUM ROW          : " << numRow_     << endl;
-  cout << " UTIL             : " << fixed << setprecision(2) << util_    * 100 << "%\n";
-  cout << " DENSITIY         : " << fixed << setprecision(2) << density_ * 100 << "%\n";
-  cout << " AREA (INSTANACE) : " << setw(16) << sumTotalInstArea_ << endl;
-  cout << " AREA (STD CELL)  : " << setw(16) << sumStdCellArea_   << endl;
-  cout << " AREA (MACRO)     : " << setw(16) << sumMacroArea_     << endl;
-  cout << " AREA (DIE)       : " << setw(16) << die_.area()       << endl;
-  cout << " AREA (CORE)      : " << setw(16) << die_.coreArea()   << endl;
-  cout << " DIE  ( " << setw(5) << dieLx  << " ";
-  cout << setw(5) << dieLy  << " ) ( ";
-  cout << setw(8) << dieUx  << " " << dieUy  << " )\n";
-  cout << " CORE ( " << setw(5) << coreLx << " ";
-  cout << setw(5) << coreLy << " ) ( ";
-  cout << setw(8) << coreUx << " " << coreUy << " )\n";
-  cout << "---------------------------------------------" << endl;
+
+  // Stream state is restored at the end (os can be shared)
+  ios_base::fmtflags flags = os.flags();
+  streamsize precision     = os.precision();
+
+  os << endl;
+  os << "*** Summary of Information ***" << endl;
+  os << "---------------------------------------------" << endl;
+  os << " TECHNOLOGY INFO"                           << endl;
+  os << "---------------------------------------------" << endl;
+  os << " NUM LEF MACRO    : " << macros_.size() << endl;
+  os << " NUM LEF SITE     : " << sites_.size()  << endl;
+  os << " DATABASE UNIT    : " << dbUnit_ << endl;
+  os << "---------------------------------------------" << endl;
+  os << " DESIGN INFO"                               << endl;
+  os << "---------------------------------------------" << endl;
+  os << " DESIGN NAME      : " << designName_ << endl;
+  os << " NUM PI           : " << numPI_      << endl;
+  os << " NUM PO           : " << numPO_      << endl;
+  os << " NUM IO           : " << numIO_      << endl;
+  os << " NUM INSTANCE     : " << numInst_    << endl;
+  os << " NUM MACRO        : " << numMacro_   << endl;
+  os << " NUM STD CELL     : " << numStdCell_ << endl;
+  os << " NUM NET          : " << numNet_     << endl;
+  os << " NUM TIE NET      : " << numTieNet_  << endl;
+  os << " NUM PIN          : " << numPin_     << endl;
+  os << " NUM DUMMY        : " << numDummy_   << endl;
+  os << " NUM ROW          : " << numRow_     << endl;
+  os << " UTIL             : " << fixed << setprecision(2) << util_    * 100 << "%\n";
+  os << " DENSITIY         : " << fixed << setprecision(2) << density_ * 100 << "%\n";
+  os << " AREA (INSTANACE) : " << setw(16) << sumTotalInstArea_ << endl;
+  os << " AREA (STD CELL)  : " << setw(16) << sumStdCellArea_   << endl;
+  os << " AREA (MACRO)     : " << setw(16) << sumMacroArea_     << endl;
+  os << " AREA (DIE)       : " << setw(16) << die_.area()       << endl;
+  os << " AREA (CORE)      : " << setw(16) << die_.coreArea()   << endl;
+  os << " DIE  ( " << setw(5) << dieLx  << " ";
+  os << setw(5) << dieLy  << " ) ( ";
+  os << setw(8) << dieUx  << " " << dieUy  << " )\n";
+  os << " CORE ( " << setw(5) << coreLx << " ";
+  os << setw(5) << coreLy << " ) ( ";
+  os << setw(8) << coreUx << " " << coreUy << " )\n";
+  os << "---------------------------------------------" << endl;
+
+  os.flags(flags);
+  os.precision(precision);
 }
 
 };
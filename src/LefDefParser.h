@@ -4,10 +4,17 @@
 #include <memory>
 #include <vector>
 #include <set>
+#include <deque>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <climits>
+#include <mutex>
+#include <tuple>
+#include <algorithm>
+
+#include "Status.h"
 
 namespace LefDefDB
 {
@@ -33,6 +40,12 @@ struct LefRect
     : lx(lx), ly(ly), ux(ux), uy(uy) {}
 };
 
+// Name of one bit of a bus (e.g. xx[3])
+inline std::string bitName(const std::string& busName, int bit)
+{
+  return busName + "[" + std::to_string(bit) + "]";
+}
+
 class LefMacro;
 class LefPin;
 class LefSite;
@@ -136,9 +149,8 @@ class LefMacro
 
     void addPin(LefPin pin)               
     { 
+      pinMap_[pin.name()] = pins_.size();
       pins_.push_back(pin); 
-      const LefPin* pinPtr = &(pins_[pins_.size() - 1]);
-      pinMap_[pinPtr->name()] = pinPtr;
     }
 
     // Getters
@@ -154,7 +166,12 @@ class LefMacro
 
     const std::vector<LefPin>& pins() const { return pins_; }
 
-    const LefPin* getPin(std::string& pinName) { return pinMap_[pinName]; }
+    // Returns nullptr if there is no such pin
+    const LefPin* getPin(const std::string& pinName) const
+    { 
+      auto findPin = pinMap_.find(pinName);
+      return (findPin == pinMap_.end()) ? nullptr : &(pins_[findPin->second]);
+    }
 
     void printInfo() const;
 
@@ -166,7 +183,7 @@ class LefMacro
 
     std::vector<LefPin> pins_;
 
-    std::unordered_map<std::string, const LefPin*> pinMap_;
+    std::unordered_map<std::string, int> pinMap_; // Name - Index of pins_
 
     float sizeX_;
     float sizeY_;
@@ -179,20 +196,34 @@ class dbNet
 {
   public:
 
-    dbNet() {}
+    dbNet() : busName_ (nullptr), isTie_ (false) {}
     dbNet(int netID, std::string& netName) 
       : id_      (netID  ),
-        netName_ (netName)
+        netName_ (netName),
+        busName_ (nullptr),
+        bit_     (0      ),
+        isTie_   (false  )
+    {}
+
+    // for one bit of a bus (the name is made only when it is needed)
+    dbNet(int netID, const std::string* busName, int bit) 
+      : id_      (netID  ),
+        busName_ (busName),
+        bit_     (bit    ),
+        isTie_   (false  )
     {}
 
     // Getters
     int           id() const { return id_;      }
-    std::string name() const { return netName_; }
+    std::string name() const { return busName_ ? bitName(*busName_, bit_) : netName_; }
+    bool       isTie() const { return isTie_;   } // Connected to 1'b0 / 1'b1
 
     const std::vector<dbPin*>& pins() const { return pins_; }
   
     // Setters
+    void setId  (int            netID) { id_      = netID;   }
     void setName(std::string& netName) { netName_ = netName; }
+    void setTie (bool           isTie) { isTie_   = isTie;   }
     void addPin (dbPin* pin) { pins_.push_back(pin); }
 
   private:
@@ -201,6 +232,11 @@ class dbNet
 
     std::string netName_;
 
+    const std::string* busName_; // nullptr if this is not a bit of bus
+    int                bit_;
+
+    bool isTie_;
+
     std::vector<dbPin*> pins_;
 };
 
@@ -216,7 +252,36 @@ class dbPin
       : id_        (pinID   ),
         nid_       (netID   ),
         ioid_      (ioID    ),
-        pinName_   (pinName )
+        cx_        (0       ),
+        cy_        (0       ),
+        offsetX_   (0       ),
+        offsetY_   (0       ),
+        pinName_   (pinName ),
+        busName_   (nullptr ),
+        bit_       (0       )
+    {
+      cid_        = INT_MAX;
+      lefPin_     = nullptr;
+      dbCell_     = nullptr;
+
+      isExternal_ = true;
+    }
+
+    // for external pins of a bus (the name is made only when it is needed)
+    dbPin(int pinID, 
+          int netID,
+          int  ioID,
+          const std::string* busName,
+          int bit)
+      : id_        (pinID   ),
+        nid_       (netID   ),
+        ioid_      (ioID    ),
+        cx_        (0       ),
+        cy_        (0       ),
+        offsetX_   (0       ),
+        offsetY_   (0       ),
+        busName_   (busName ),
+        bit_       (bit     )
     {
       cid_        = INT_MAX;
       lefPin_     = nullptr;
@@ -226,23 +291,29 @@ class dbPin
     }
 
     // for internal pins
+    // (LefPin is in micron, offset is in dbu)
     dbPin(int pinID, 
           int cellID, 
           int netID,
           std::string& pinName,
-          const LefPin* lefPin)
+          const LefPin* lefPin,
+          int dbUnit)
 
       : id_        (pinID    ),
         cid_       (cellID   ),
         nid_       (netID    ),
+        cx_        (0        ),
+        cy_        (0        ),
         pinName_   (pinName  ),
+        busName_   (nullptr  ),
+        bit_       (0        ),
         lefPin_    (lefPin   )
     {
       ioid_ = INT_MAX;
       dbIO_ = nullptr;
   
-      offsetX_ = ( lefPin->lx() + lefPin->ux() ) / 2;
-      offsetY_ = ( lefPin->ly() + lefPin->uy() ) / 2;
+      offsetX_ = static_cast<int>( ( lefPin->lx() + lefPin->ux() ) / 2 * dbUnit );
+      offsetY_ = static_cast<int>( ( lefPin->ly() + lefPin->uy() ) / 2 * dbUnit );
 
       isExternal_ = false;
     }
@@ -251,6 +322,9 @@ class dbPin
     void setNet     (dbNet*   net) { dbNet_  = net;      }
     void setCell    (dbCell* cell) { dbCell_ = cell;     }
     void setIO      (dbIO*     io) { dbIO_   = io;       }
+    void setNid     (int    netID) { nid_    = netID;    }
+    void setId      (int    pinID) { id_     = pinID;    }
+    void setCid     (int   cellID) { cid_    = cellID;   }
 
     void setCx      (int       cx) { cx_     = cx;       }
     void setCy      (int       cy) { cy_     = cy;       }
@@ -269,7 +343,7 @@ class dbPin
     int          offsetX() const { return offsetX_;    }
     int          offsetY() const { return offsetY_;    }
 
-    std::string     name() const { return pinName_;    }
+    std::string     name() const { return busName_ ? bitName(*busName_, bit_) : pinName_; }
 
     dbCell*         cell() const { return dbCell_;     }
     dbNet*           net() const { return dbNet_;      }
@@ -294,6 +368,9 @@ class dbPin
 
     std::string pinName_;
 
+    const std::string* busName_; // nullptr if this is not a bit of bus
+    int                bit_;
+
     dbCell* dbCell_;
     dbNet*  dbNet_;
     dbIO*   dbIO_;
@@ -313,8 +390,31 @@ class dbIO
          PinDirection direction,
          std::string& name) 
       : id_         (      ioID),
+        lx_         (         0),
+        ly_         (         0),
+        dx_         (         0),
+        dy_         (         0),
+        direction_  ( direction),
+        ioName_     (      name),
+        busName_    (   nullptr),
+        bit_        (         0),
+        pin_        (   nullptr)
+    {}
+
+    // for one bit of a bus (the name is made only when it is needed)
+    dbIO(int ioID, 
+         PinDirection direction,
+         const std::string* busName,
+         int bit) 
+      : id_         (      ioID),
+        lx_         (         0),
+        ly_         (         0),
+        dx_         (         0),
+        dy_         (         0),
         direction_  ( direction),
-        ioName_     (      name) 
+        busName_    (   busName),
+        bit_        (       bit),
+        pin_        (   nullptr)
     {}
 
     // If DEF is read first (before reading .v)
@@ -335,7 +435,10 @@ class dbIO
         dy_         (        dy),
         orient_     (    orient),
         direction_  ( direction),
-        ioName_     (      name) 
+        ioName_     (      name),
+        busName_    (   nullptr),
+        bit_        (         0),
+        pin_        (   nullptr)
     {}
 
     // Getters
@@ -362,7 +465,7 @@ class dbIO
     bool     isFixed() const { return isFixed_;       }
 
     dbPin*       pin() const { return pin_;           }
-    std::string name() const { return ioName_;        }
+    std::string name() const { return busName_ ? bitName(*busName_, bit_) : ioName_; }
 
     Orient          orient() const { return orient_;    }
     PinDirection direction() const { return direction_; }
@@ -427,10 +530,55 @@ class dbIO
     PinDirection direction_;
     std::string  ioName_;
 
+    const std::string* busName_; // nullptr if this is not a bit of bus
+    int                bit_;
+
     dbPin* pin_;
 };
 
 
+// Bus of the top module (e.g. input [31:16] xx;)
+// Bits of a bus have contiguous IDs,
+// so the ID of xx[i] is computed by arithmetic (no string hashing).
+class dbBus
+{
+  public:
+
+    dbBus(int msb, int lsb, int firstNetID, int firstIOID, int firstPinID)
+      : msb_        (       msb),
+        lsb_        (       lsb),
+        firstNetID_ (firstNetID),
+        firstIOID_  ( firstIOID),
+        firstPinID_ (firstPinID)
+    {}
+
+    // Getters
+    int        msb() const { return msb_;        }
+    int        lsb() const { return lsb_;        }
+    int       high() const { return std::max(msb_, lsb_);  }
+    int        low() const { return std::min(msb_, lsb_);  }
+    int      width() const { return high() - low() + 1;     }
+
+    int firstNetID() const { return firstNetID_; }
+    int  firstIOID() const { return firstIOID_;  } // -1 if this is not a port
+    int firstPinID() const { return firstPinID_; } // -1 if this is not a port
+
+    // Offset of the given bit from the first ID (-1 if out of range)
+    int offset(int bit) const 
+    { 
+      return (bit < low() || bit > high()) ? -1 : bit - low(); 
+    }
+
+  private:
+
+    int msb_;
+    int lsb_;
+
+    int firstNetID_;
+    int firstIOID_;
+    int firstPinID_;
+};
+
 class dbCell
 {
   public:
@@ -451,10 +599,16 @@ class dbCell
         isStdCell_ = false;
       }
 
-      isDummy_ = false;
+      isDummy_    = false;
+      isFixed_    = false;
+      cellOrient_ = Orient::N;
+
+      lx_ = 0;
+      ly_ = 0;
     }
 
     // Setters
+    void setId         (int         cellID  ) { id_         = cellID;     }
     void setName       (std::string&  name  ) { cellName_   = name;       }
     void setLefMacro   (LefMacro* lefMacro  ) { lefMacro_   = lefMacro;   }
     void setOrient     (Orient  cellOrient  ) { cellOrient_ = cellOrient; }
@@ -467,7 +621,7 @@ class dbCell
     void addPin        (dbPin*         pin  ) { pins_.push_back(pin);     }
 
     // Getters
-    std::string     name()  const { return cellName_;   }
+    const std::string& name() const { return cellName_; }
     int               id()  const { return id_;         }
     int               lx()  const { return lx_;         }
     int               ly()  const { return ly_;         }
@@ -522,6 +676,16 @@ class dbCell
     int dy_;
 };
 
+// Location of a pin (dbu)
+// Internal pin : computed by LefDefParser::updatePinLocations / moveCell
+//                (cell position + LEF pin center with the macro ORIGIN and the cell orientation)
+// External pin : center of the dbIO
+inline void pinLocation(const dbPin* pin, int& x, int& y)
+{
+  x = pin->cx();
+  y = pin->cy();
+}
+
 class dbRow
 {
   public:
@@ -643,6 +807,137 @@ class dbDie
     int coreUy_;
 };
 
+// Module definition of a hierarchical Verilog netlist.
+// Only the location of the module in the token list is stored first,
+// and the body is parsed when the module is instantiated for the first time.
+// Every net (bit) inside the module has a local net ID.
+class VerilogModule
+{
+  public:
+
+    // Special local net IDs
+    static constexpr int TIE0   = -1;                                   // 1'b0
+    static constexpr int TIE1   = -2;                                   // 1'b1
+    static constexpr int NO_NET = -3;                                   // Unconnected
+
+    struct Port
+    {
+      std::string      name;
+      PinDirection     direction;
+      int              offset;                                      // Offset in the list of all port bits
+      std::vector<int> bits;                                        // Local net IDs (MSB first)
+    };
+
+    struct Conn
+    {
+      std::string      portName;
+      bool             isBus;                                       // Connected to a bus or {...}
+      std::vector<int> bits;                                        // Local net IDs (MSB first)
+    };
+
+    struct Inst
+    {
+      std::string       typeName;                                   // LEF MACRO or Verilog module
+      std::string       instName;
+      std::vector<Conn> conns;
+    };
+
+    VerilogModule(std::string& name, strIter begin, strIter end)
+      : name_      (name ),
+        begin_     (begin),
+        end_       (end  ),
+        numPortBit_(    0)
+    {}
+
+    void parse();                                                   // Parse the body (only once, thread-safe)
+
+    // Getters
+    std::string                 name() const { return name_;       }
+    strIter                    begin() const { return begin_;      }
+    strIter                      end() const { return end_;        }
+
+    int                       numNet() const { return netNames_.size(); }
+    int                   numPortBit() const { return numPortBit_; }
+
+    const std::string& netName(int netID) const { return netNames_[netID]; }
+
+    const std::vector<Port>&   ports() const { return ports_;      }
+    const std::vector<Inst>&   insts() const { return insts_;      }
+
+    const std::vector<std::pair<int, int>>& assigns() const { return assigns_; }
+
+    const Port* findPort(const std::string& portName) const;         // Returns nullptr if there is no such port
+
+  private:
+
+    std::string name_;
+
+    strIter begin_;                                                 // module
+    strIter end_;                                                   // endmodule
+
+    std::once_flag parseFlag_;
+
+    int numPortBit_;
+
+    std::vector<Port>        ports_;
+    std::vector<Inst>        insts_;
+    std::vector<std::string> netNames_;
+    std::vector<std::pair<int, int>> assigns_;
+
+    std::unordered_map<std::string, int> portMap_;                  // PortName - Index of ports_
+    std::unordered_map<std::string, int> netMap_;                   // NetName  - Local NetID (scalar)
+    std::unordered_map<std::string, std::tuple<int, int, int>> busMap_; // BusName - (First NetID, MSB, LSB)
+
+    void readDecl   (strIter& itr, bool isPort, PinDirection direction);    // input / output / wire
+    void readInst   (strIter& itr);                                         // One instance
+    void readAssign (strIter& itr);                                         // One assign
+
+    int  addNet     (const std::string& netName);
+    void addBus     (const std::string& busName, int msb, int lsb);
+    void addPort    (const std::string& portName, PinDirection direction);
+
+    void getNets    (const std::string& item, std::vector<int>& bits);      // Item of net expression -> Local NetIDs
+};
+
+// Flattened part of a hierarchical netlist (one top-level instance).
+// Net references of pins are
+//   >= 0        : Net ID in the parser (nets of the top module)
+//   TIE0 / TIE1 : Shared tie nets
+//   NO_NET      : Unconnected
+//   < 0         : -(index of nets + 1)
+struct FlatChunk
+{
+  static constexpr int TIE0   = INT_MIN;
+  static constexpr int TIE1   = INT_MIN + 1;
+  static constexpr int NO_NET = INT_MIN + 2;
+
+  std::vector<dbCell> cells;
+  std::vector<dbPin>  pins;
+  std::vector<dbNet>  nets;
+
+  std::vector<std::pair<int, int>> assigns;
+
+  int numStdCell = 0;
+  int numMacro   = 0;
+  int numTieNet  = 0;
+};
+
+// Placement snapshot of one DEF (indexed by CellID)
+// Only positions are read, so many DEFs of the same design
+// can be loaded without re-building (or touching) the DB.
+struct dbPlacement
+{
+  std::vector<int>    lx;
+  std::vector<int>    ly;
+  std::vector<Orient> orient;
+  std::vector<char>   isFixed;
+
+  int numPlaced = 0;                                                  // Number of placed COMPONENTS in the DEF
+
+  std::vector<int> order;                                             // CellID of each COMPONENT in the last DEF
+                                                                      // (hint for the next DEF, -1 if dummy)
+};
+
 class LefDefParser
 {
   public:
@@ -650,10 +945,36 @@ class LefDefParser
     LefDefParser();
 
     // APIs
-    void readLef     (const std::filesystem::path& path);                      // Read LEF
-    void readDef     (const std::filesystem::path& path);                      // Read DEF
-    void readVerilog (const std::filesystem::path& path);                      // Read Netlist (.v)
-    void printInfo   ();                                                       // Print Technology & Design Information
+    // On failure, the DB is rolled back to the state before the call
+    // and the error message is returned in the Status.
+    Status readLef     (const std::filesystem::path& path);                    // Read LEF
+    Status readDef     (const std::filesystem::path& path);                    // Read DEF (once, after LEF)
+    Status readVerilog (const std::filesystem::path& path,                     // Read Netlist (.v) (once, after LEF)
+                        bool perCellTie = false);                              // (true : tie stubs for each instance
+                                                                               //  instead of shared tie nets)
+    void   printInfo   (std::ostream& os = std::cout) const;                   // Print Technology & Design Information
+
+    // Incremental DEF (only COMPONENTS positions of the cells already in the DB)
+    // readDefPlacement is const and can be called from multiple threads.
+    Status readDefPlacement (const std::filesystem::path& path,                // DEF -> Snapshot
+                             dbPlacement& placement) const;                    // (starts from the current positions,
+                                                                               //  unspecified on failure)
+    Status applyPlacement   (const dbPlacement& placement);                    // Snapshot -> DB
+
+    // Absolute locations of the internal pins (dbPin::cx / cy)
+    // Computed after readDef / applyPlacement, and for one cell by moveCell.
+    void updatePinLocations();                                                 // Every cell (in parallel)
+    void moveCell  (int cellID, int lx, int ly);                               // Move the cell and its pins
+    void pinOffset (const dbPin* pin, int& ox, int& oy) const;                 // Pin center - lower-left of the cell (oriented)
+
+    Status unloadDef();                                                        // Back to the state before readDef
+                                                                               // (to read another DEF on the same netlist)
+
+    // Options
+    void setNumThreads (int  numThreads) { numThreads_ = numThreads; }         // Number of threads for parallel jobs
+
+    int  numThreads() const { return numThreads_; }
+    bool isDefLoaded() const { return ifReadDef_;  }
 
     // Getters
     const std::vector<dbCell*>& cells() const { return dbCellPtrs_; }          // List of DEF COMPONENTS
@@ -666,6 +987,21 @@ class LefDefParser
 
     std::string     designName() const { return designName_; }                 // Returns the top module name (from .v)
 
+    int          findNetID(const std::string& netName) const;                 // NetID of the given name (-1 if not found)
+    int           findIOID(const std::string&  ioName) const;                 //  IOID of the given name (-1 if not found)
+    const LefMacro* findMacro(const std::string& macroName) const;             // MACRO of the given name (nullptr if not found)
+
+    // Stages of the readers alone (for microbenchmarks)
+    // The tokens are moved by the readers. On failure, the DB is rolled back.
+    enum class FileType { LEF, VERILOG, DEF };
+
+    std::vector<std::string> tokenize(const std::filesystem::path& path,       // Tokens with the delimiters of the file type
+                                      FileType type);                          // (throws ParseError)
+    Status readLefMacros     (std::vector<std::string>& tokens);               // Every MACRO of LEF tokens (replaces the MACROs,
+                                                                               //  so only before readVerilog / readDef)
+    Status readDefComponents (std::vector<std::string>& tokens);               // COMPONENTS ... END COMPONENTS of DEF tokens
+                                                                               // (after readDef, only the cells in the DB)
+
   private:
 
     // Tokenize strings of input file
@@ -673,11 +1009,50 @@ class LefDefParser
                                             std::string_view dels,             // Delimiters
                                             std::string_view exps);            // Exceptions
 
+    // Delimiters (dropped) / Exceptions (delimiters kept as a token) of each format
+    // (old Verilog delimiters : "(),:;/#[]{}*\"\\" / "().;")
+    static constexpr std::string_view lefDelimiters_     = "#;";
+    static constexpr std::string_view lefExceptions_     = "";
+    static constexpr std::string_view verilogDelimiters_ = "(),;#{}*";
+    static constexpr std::string_view verilogExceptions_ = "().;{}";
+    static constexpr std::string_view defDelimiters_     = "#";
+    static constexpr std::string_view defExceptions_     = "";
+
+    int numThreads_;                                                           // Number of threads
+
     bool ifReadLef_;                                                           // LEF     Flag
     bool ifReadVerilog_;                                                       // Verilog Flag
     bool ifReadDef_;                                                           // DEF     Flag
 
     void reset();                                                              // Reset Function (clear or initialize all db)
+    void clearNetlist();                                                       // Clear the Verilog-related db (rollback of readVerilog)
+
+    // State before readDef (restored by the rollback of readDef and unloadDef)
+    // DEF moves the cells / IOs, appends dummy cells and rows and sets the die and the statistics.
+    struct DefBase
+    {
+      dbPlacement       placement;                                             // Cells (from Verilog)
+      std::vector<dbIO> ios;
+      dbDie             die;
+
+      int numCell    = 0;                                                      // Size of dbCellInsts_ (without dummy cells)
+      int numInst    = 0;
+      int numStdCell = 0;
+      int numMacro   = 0;
+      int numDummy   = 0;
+    };
+
+    DefBase defBase_;
+
+    void saveDefBase();
+    void restoreDefBase();
+
+    // Bodies of the APIs (throw ParseError)
+    void readLefFile          (const std::filesystem::path& path);
+    void readVerilogFile      (const std::filesystem::path& path);
+    void readDefFile          (const std::filesystem::path& path);
+    void readDefPlacementFile (const std::filesystem::path& path,
+                               dbPlacement& placement) const;
 
     // LEF-related
     int dbUnit_;                                                               // LEF DATABASE MICRONS
@@ -717,6 +1092,7 @@ class LefDefParser
     int numNet_;                                                               // Number of Nets
     int numPin_;                                                               // Number of Pins
     int numDummy_;                                                             // Number of Dummy Cells
+    int numTieNet_;                                                            // Number of Tie Nets (1'b0 / 1'b1)
     // In the ICCAD 2015 superblue benchmarks, 
     // there are some cells that exist in DEF
     // but not in the Verilog,
@@ -724,6 +1100,7 @@ class LefDefParser
 
     std::vector<dbCell*> dbCellPtrs_;                                          // List of dbCell Pointer
     std::vector<dbCell>  dbCellInsts_;                                         // List of dbCell Instance
+    std::deque<dbCell>   dbDummyInsts_;                                        // Dummy Cells (stable addresses while DEF is read)
 
     std::vector<dbPin*>  dbPinPtrs_;                                           // List of dbPin Pointer
     std::vector<dbPin>   dbPinInsts_;                                          // List of dbPin Instance
@@ -738,6 +1115,54 @@ class LefDefParser
     std::unordered_map<std::string, int> strToNetID_;                          //  NetName -  NetID Table
     std::unordered_map<std::string, int> strToPinID_;                          //  PinName -  PinID Table
     std::unordered_map<std::string, int> strToIOID_;                           //   IOName -   IOID Table
+    std::unordered_map<std::string, dbBus> strToBus_;                          //  BusName -    Bus Table
+    // Names of bus bits are not in the tables above (use strToBus_ instead)
+
+    std::vector<int> netAlias_;                                                // Original NetID - Canonical NetID (after assign)
+
+    std::vector<int> netParent_;                                               // Union-Find Parent of each Net (for assign)
+
+    int  findNetRoot          (int netID);                                     // Find the root Net of Union-Find
+    void mergeNets            (int netID1, int netID2);                        // Union two Nets aliased by assign
+    void readVerilogAssign    (strIter& itr, const strIter& end);              // Read One assign statement
+    void collapseAssignedNets ();                                              // Renumber Nets into canonical Nets
+
+    bool perCellTie_;                                                          // Tie Mode (Shared Tie Nets / Per-Cell Tie Stubs)
+    int  tieNetID_[2];                                                         // ID of Shared Tie Nets (-1 if not made yet)
+
+    int  makeTieNet           (std::string& netName);                          // Make a new Tie Net
+    int  getSharedTieNetID    (int value);                                     // Get (or make) the Shared Tie Net of 1'b0 / 1'b1
+    void splitSharedTieNets   ();                                              // Move the cell pins on Shared Tie Nets to Per-Cell Tie Stubs
+
+    // Hierarchical Verilog
+    struct HierInst                                                            // Top-level instance of a Verilog module
+    {
+      VerilogModule*   module;
+      std::string      instName;
+      std::vector<int> portNets;                                               // NetIDs connected to each port bit
+    };
+
+    std::vector<std::unique_ptr<VerilogModule>>     modules_;                  // List of Verilog modules
+    std::unordered_map<std::string, VerilogModule*> moduleMap_;                // Name - Module Table
+
+    VerilogModule* findTopModule    (strIter begin, const strIter& end);       // Make Module Table & find the top module
+
+    bool getTopNets       (const std::string& item,                            // Item of net expression -> NetIDs (false if not found)
+                           std::vector<int>& bits);                            // (1'b0 / 1'b1 -> VerilogModule::TIE0 / TIE1)
+
+    void readHierInst     (strIter& itr, const strIter& end,                   // Read One top-level instance of a module
+                           VerilogModule* module,
+                           std::vector<HierInst>& hierInsts);
+
+    void flattenModule    (const VerilogModule* module,                        // Flatten a module instance into a chunk
+                           const std::string& prefix,
+                           const std::vector<int>& portNets,
+                           FlatChunk& chunk) const;
+
+    void checkModuleCycle (const VerilogModule* topModule,                     // parseError if a module instantiates itself
+                           const std::vector<HierInst>& hierInsts) const;      // (directly or through submodules)
+    void flattenHierInsts (std::vector<HierInst>& hierInsts);                  // Flatten top-level instances in parallel
+    void mergeFlatChunk   (FlatChunk& chunk);                                  // Append a chunk to the DB
 
     // DEF-related
     int numRow_;                                                               // Number of ROWS       in DEF
@@ -1,13 +1,24 @@
 #include "Painter.h"
+#include "GifWriter.h"
 #include "LefDefParser.h"
+#include "RTree.h"
+#include "Parallel.h"
 #include "CImg.h"
-#include <stdio.h>
+
+// Xlib (included by CImg) defines Status as int,
+// which hides LefDefDB::Status
+#ifdef Status
+#undef Status
+#endif
+
+#include <cstdio>
 #include <string>
 #include <iostream>
 #include <climits>   // For INT_MAX, INT_MIN
 #include <cfloat>    // For FLT_MAX
 #include <cmath>
 #include <random>
+#include <chrono>
 
 // Not a real size
 // MAX_W, MAX_H is just a imaginary size
@@ -27,6 +38,23 @@
 #define MACRO_OPACITY       0.7
 #define STD_CELL_OPACITY    0.7
 
+// Level-of-Detail Rendering
+// Cells smaller than LOD_PIXEL_THRESHOLD (in pixel) are not drawn
+// one by one, but accumulated into a per-tile coverage buffer.
+// A tile is 'dense' if its average cell pitch is smaller than the threshold,
+// then every cell of the tile is accumulated.
+#define LOD_TILE_SIZE       64
+#define LOD_PIXEL_THRESHOLD  2
+
+// Tile size of the image pyramid (Interactive Mode)
+#define PYRAMID_TILE_SIZE  256
+
+// Finest level of the net overlay grid (2^8 x 2^8 buckets)
+#define NET_OVERLAY_MAX_LEVEL 8
+
+// Heatmap (draw_density, draw_rudy)
+#define HEATMAP_OPACITY      0.7
+
 #define DIE_LINE_THICKNESS      1
 #define MACRO_LINE_THICKNESS    0
 #define STD_CELL_LINE_THICKNESS 0
@@ -46,45 +74,75 @@ static const Color DIE_LINE_COLOR        = black;
 static const Color MACRO_LINE_COLOR      = black;
 static const Color STD_CELL_LINE_COLOR   = red; // for gif plot mode, red will look better 
 
+// printf to std::cout
+// (the server sends std::cout of a command to the client)
+template<typename... Args>
+inline void coutf(const char* format, Args... args)
+{
+  int size = std::snprintf(nullptr, 0, format, args...);
+
+  std::string str(size, '\0');
+  std::snprintf(str.data(), size + 1, format, args...);
+
+  std::cout << str;
+}
+
 inline void printInterfaceMessage()
 {
-  printf("Graphic Interface Manual\n");
-  printf("[Q]: Close the window\n");
-  printf("[Z]: Zoom In\n");
-  printf("[X]: Zoom Out\n");
-  printf("[F]: Zoom to Fit\n");
-  printf("[H]: Print Key Map\n");
-  printf("[UP DOWN LEFT DOWN]: Move Zoom Box\n");
+  std::cout << "Graphic Interface Manual" << std::endl;
+  std::cout << "[Q]: Close the window" << std::endl;
+  std::cout << "[Z]: Zoom In" << std::endl;
+  std::cout << "[X]: Zoom Out" << std::endl;
+  std::cout << "[F]: Zoom to Fit" << std::endl;
+  std::cout << "[H]: Print Key Map" << std::endl;
+  std::cout << "[UP DOWN LEFT DOWN]: Move Zoom Box" << std::endl;
 }
 
 // Painter Interface //
 Painter::Painter()
+  : img_          (nullptr),
+    background_   (nullptr),
+    window_       (nullptr),
+    heatmap_      (nullptr),
+    heatmapRange_ (1.0f   )
 {}
 
+Painter::~Painter()
+{
+  delete img_;
+  delete background_;
+}
+
 void
 Painter::init()
 {
-  offsetX_ = DIE_OFFSET_X;
-  offsetY_ = DIE_OFFSET_Y;
+  init(MAX_W + 2 * DIE_OFFSET_X, MAX_H + 2 * DIE_OFFSET_Y);
 
-  canvasX_ = MAX_W + 2 * DIE_OFFSET_X;
-  canvasY_ = MAX_H + 2 * DIE_OFFSET_Y;
+  // img_ := Original image which represents the whole placement
+  // any 'zoomed' image is composed from the pyramid of this img_
+  delete img_;
+  img_ = new CImg<unsigned char>(canvasX_, canvasY_, 1, 3, 255);
+}
 
-  // canvas is just a background image for placement visualization
-  canvas_ = new CImg<unsigned char>(canvasX_, canvasY_, 1, 3, 255);
-  canvas_->draw_rectangle(0, 0, canvasX_, canvasY_, white);
+void
+Painter::init(int width, int height)
+{
+  offsetX_ = DIE_OFFSET_X;
+  offsetY_ = DIE_OFFSET_Y;
 
-  // img_ := Original image which represents the whole placement
-  // any 'zoomed' image will use a crop of this img_
-  img_ = new CImg<unsigned char>(*canvas_);
+  canvasX_ = width;
+  canvasY_ = height;
 
   maxWidth_  = db_->die()->ux();
   maxHeight_ = db_->die()->uy();
 
-  double scaleX = double(MAX_W) / double(maxWidth_ );
-  double scaleY = double(MAX_H) / double(maxHeight_);
+  double scaleX = double(canvasX_ - 2 * offsetX_) / double(maxWidth_ );
+  double scaleY = double(canvasY_ - 2 * offsetY_) / double(maxHeight_);
 
   scale_ = std::min(scaleX, scaleY);
+
+  numTileX_ = (canvasX_ + LOD_TILE_SIZE - 1) / LOD_TILE_SIZE;
+  numTileY_ = (canvasY_ + LOD_TILE_SIZE - 1) / LOD_TILE_SIZE;
 }
 
 int
@@ -119,6 +177,18 @@ Painter::getY(float dbY)
   return (static_cast<int>(tempY) + offsetY_);
 }
 
+double
+Painter::toScreenX(double dbX)
+{
+  return scale_ * dbX + offsetX_;
+}
+
+double
+Painter::toScreenY(double dbY)
+{
+  return scale_ * (maxHeight_ - dbY) + offsetY_;
+}
+
 void 
 Painter::drawLine(CImgObj *img, 
                   int x1, 
@@ -212,12 +282,12 @@ Painter::drawDie(CImgObj *img)
 }
 
 void
-Painter::drawCell(CImgObj *img, const dbCell* cell)
+Painter::drawCell(CImgObj *img, const dbCell* cell, int shiftY)
 {
   int newLx = getX(cell->lx());
-  int newLy = getY(cell->ly());
+  int newLy = getY(cell->ly()) - shiftY;
   int newUx = getX(cell->ux());
-  int newUy = getY(cell->uy());
+  int newUy = getY(cell->uy()) - shiftY;
 
   if(cell->isMacro())
   {
@@ -238,12 +308,12 @@ Painter::drawCell(CImgObj *img, const dbCell* cell)
 }
 
 void
-Painter::drawFixed(CImgObj *img, const dbCell* cell)
+Painter::drawFixed(CImgObj *img, const dbCell* cell, int shiftY)
 {
   int newLx = getX(cell->lx());
-  int newLy = getY(cell->ly());
+  int newLy = getY(cell->ly()) - shiftY;
   int newUx = getX(cell->ux());
-  int newUy = getY(cell->uy());
+  int newUy = getY(cell->uy()) - shiftY;
 
   if(cell->isFixed())
   {
@@ -255,12 +325,12 @@ Painter::drawFixed(CImgObj *img, const dbCell* cell)
 }
 
 void
-Painter::drawMovable(CImgObj *img, const dbCell* cell)
+Painter::drawMovable(CImgObj *img, const dbCell* cell, int shiftY)
 {
   int newLx = getX(cell->lx());
-  int newLy = getY(cell->ly());
+  int newLy = getY(cell->ly()) - shiftY;
   int newUx = getX(cell->ux());
-  int newUy = getY(cell->uy());
+  int newUy = getY(cell->uy()) - shiftY;
 
   if(!cell->isFixed())
   {
@@ -272,134 +342,1377 @@ Painter::drawMovable(CImgObj *img, const dbCell* cell)
 }
 
 void
-Painter::drawCells(CImgObj *img)
+Painter::drawBox(CImgObj *img, const CellBox& box, int shiftY)
 {
-  for(auto &c : db_->cells())
+  int newLx = getX(box.lx);
+  int newLy = getY(box.ly) - shiftY;
+  int newUx = getX(box.ux);
+  int newUy = getY(box.uy) - shiftY;
+
+  if(box.isBlock)
   {
-    if( c->isFixed() )
-      drawFixed(img, c);
-    else
-      drawCell(img, c);
+    drawRect(img, newLx, newLy, newUx, newUy, MACRO_COLOR, 
+                                              MACRO_LINE_COLOR,
+                                              MACRO_LINE_THICKNESS, 
+                                              MACRO_OPACITY);
+  }
+  else
+  {
+    drawRect(img, newLx, newLy, newUx, newUy, STD_CELL_COLOR, 
+                                              STD_CELL_LINE_COLOR, 
+                                              STD_CELL_LINE_THICKNESS,
+                                              STD_CELL_OPACITY);
   }
 }
 
+int
+Painter::getTileID(const CellBox& box)
+{
+  int cx = static_cast<int>( toScreenX(0.5 * (box.lx + box.ux)) );
+  int cy = static_cast<int>( toScreenY(0.5 * (box.ly + box.uy)) );
+
+  cx = std::min(std::max(cx, 0), canvasX_ - 1);
+  cy = std::min(std::max(cy, 0), canvasY_ - 1);
+
+  return (cy / LOD_TILE_SIZE) * numTileX_ + (cx / LOD_TILE_SIZE);
+}
+
 void
-Painter::drawChip()
+Painter::getBandRange(const CellBox& box, int& lb, int& ub)
 {
-  init();
-  drawDie(img_);
-  drawCells(img_);
-  show();
+  // Conservative: covers both the coverage footprint 
+  // and the border lines of drawRect
+  int y0 = static_cast<int>( std::floor(toScreenY(box.uy)) );
+  int y1 = static_cast<int>( toScreenY(box.ly) );
+
+  y0 = std::min(std::max(y0, 0), canvasY_ - 1);
+  y1 = std::min(std::max(y1, 0), canvasY_ - 1);
+
+  lb = y0 / LOD_TILE_SIZE;
+  ub = y1 / LOD_TILE_SIZE;
 }
 
-void 
-Painter::show()
+void
+Painter::splatCell(TileCoverage& coverage, const CellBox& box, int bandLy, int bandUy)
 {
-  int viewX = 0;
-  int viewY = 0;
+  // Screen-space box of the cell (y is flipped)
+  // clipped to the band [bandLy, bandUy)
+  double x0 = std::max(toScreenX(box.lx), 0.0);
+  double x1 = std::min(toScreenX(box.ux), double(canvasX_));
+  double y0 = std::max(toScreenY(box.uy), double(bandLy));
+  double y1 = std::min(toScreenY(box.ly), double(bandUy));
 
-  int ZoomBoxW = MAX_H; 
-  int ZoomBoxH = MAX_W; 
+  if(x0 >= x1 || y0 >= y1)
+    return;
 
-  bool redraw = false;
+  int px0 = static_cast<int>(x0);
+  int py0 = static_cast<int>(y0);
+  int px1 = std::min(static_cast<int>(std::ceil(x1)), canvasX_) - 1;
+  int py1 = std::min(static_cast<int>(std::ceil(y1)), bandUy  ) - 1;
 
-  int lx = 0;
-  int ly = 0;
+  // Add the exact overlap area of the cell to every pixel it touches
+  for(int py = py0; py <= py1; py++)
+  {
+    float oy = std::min(y1, py + 1.0) - std::max(y0, double(py));
 
-  CImgObj ZoomBox 
-    = img_->get_crop(lx, ly, lx + canvasX_, ly + canvasY_);
+    for(int px = px0; px <= px1; px++)
+    {
+      float ox = std::min(x1, px + 1.0) - std::max(x0, double(px));
 
-  window_ = new CImgDisplay(WINDOW_W, WINDOW_H, "Placement GUI");
+      std::vector<float>& buf = coverage[px / LOD_TILE_SIZE];
 
-  printInterfaceMessage();
+      if(buf.empty())
+        buf.resize(LOD_TILE_SIZE * LOD_TILE_SIZE, 0.0f);
 
-  // Interactive Mode //
-  while(!window_->is_closed() && !window_->is_keyESC()
-                              && !window_->is_keyQ())
+      buf[(py - bandLy) * LOD_TILE_SIZE + (px % LOD_TILE_SIZE)] += ox * oy;
+    }
+  }
+}
+
+void
+Painter::blendCoverage(CImgObj *band, const TileCoverage& coverage)
+{
+  const int bandH = band->height();
+
+  for(int tileX = 0; tileX < numTileX_; tileX++)
   {
-    if(redraw)
+    const std::vector<float>& buf = coverage[tileX];
+
+    if(buf.empty())
+      continue;
+
+    int tileLx = tileX * LOD_TILE_SIZE;
+    int tileUx = std::min(tileLx + LOD_TILE_SIZE, canvasX_);
+
+    for(int y = 0; y < bandH; y++)
     {
-      img_ = new CImg<unsigned char>(*canvas_);
-      drawDie(img_);
-      drawCells(img_);
+      for(int x = tileLx; x < tileUx; x++)
+      {
+        float cov = buf[y * LOD_TILE_SIZE + (x - tileLx)];
 
-      ZoomBox 
-        = img_->get_crop(lx, ly, lx + ZoomBoxW, ly + ZoomBoxH);
-      ZoomBox.resize(*window_);
-      redraw = false;
+        if(cov <= 0.0f)
+          continue;
+
+        // Fully covered pixel looks the same as a single opaque cell
+        float alpha = STD_CELL_OPACITY * std::min(cov, 1.0f);
+
+        for(int ch = 0; ch < 3; ch++)
+        {
+          unsigned char& val = (*band)(x, y, 0, ch);
+          val = static_cast<unsigned char>(val * (1.0f - alpha) 
+                                         + STD_CELL_COLOR[ch] * alpha + 0.5f);
+        }
+      }
     }
+  }
+}
 
-    ZoomBox.display(*window_);
+void
+Painter::drawBand(CImgObj *img, int bandID,
+                  const std::vector<CellBox>& boxes,
+                  const std::vector<char>& isSmall,
+                  const int* bandCellBegin,
+                  const int* bandCellEnd)
+{
+  int bandLy = bandID * LOD_TILE_SIZE;
+  int bandUy = std::min(bandLy + LOD_TILE_SIZE, canvasY_);
 
-    if(window_->key())
+  // Private copy of the band rows (CImg clips anything outside)
+  CImgObj band = img->get_crop(0, bandLy, canvasX_ - 1, bandUy - 1);
+
+  TileCoverage coverage(numTileX_);
+
+  for(const int* itr = bandCellBegin; itr != bandCellEnd; ++itr)
+  {
+    if( isSmall[*itr] )
+      splatCell(coverage, boxes[*itr], bandLy, bandUy);
+  }
+
+  blendCoverage(&band, coverage);
+
+  for(const int* itr = bandCellBegin; itr != bandCellEnd; ++itr)
+  {
+    if( !isSmall[*itr] )
+      drawBox(&band, boxes[*itr], bandLy);
+  }
+
+  // Bands are disjoint rows of img
+  img->draw_image(0, bandLy, band);
+}
+
+void
+Painter::drawCells(CImgObj *img)
+{
+  drawCells(img, db_->numThreads());
+}
+
+void
+Painter::drawCells(CImgObj *img, int numThreads, const dbPlacement* placement)
+{
+  const std::vector<dbCell*>& cells = db_->cells();
+
+  const int numCell   = cells.size();
+  const int numTile   = numTileX_ * numTileY_;
+  const int numBand   = numTileY_;
+  const int denseTile = (LOD_TILE_SIZE * LOD_TILE_SIZE) 
+                      / (LOD_PIXEL_THRESHOLD * LOD_PIXEL_THRESHOLD);
+
+  numThreads = std::max(1, std::min(numThreads, numBand));
+
+  // Thread t takes the t-th contiguous chunk of cells in Step #1 ~ #3,
+  // so every bucket keeps the order of db_->cells()
+
+  // Step #0: Boxes of cells (from the DB or the snapshot)
+  std::vector<CellBox> boxes(numCell);
+
+  runChunks(numThreads, numCell, [&] (int t, int begin, int end)
+  {
+    for(int i = begin; i < end; i++)
     {
-      switch(window_->key())
+      const dbCell* c = cells[i];
+
+      CellBox& box = boxes[i];
+
+      if(placement == nullptr)
       {
-        case cimg::keyARROWUP:
-          if(check_inside(lx, ly - MOVE_SPEED, ZoomBoxW, ZoomBoxH))
-          {
-            ly -= MOVE_SPEED;
-            redraw = true;
-          }
-          break;
-        case cimg::keyARROWDOWN:
-          if(check_inside(lx, ly + MOVE_SPEED, ZoomBoxW, ZoomBoxH))
-          {
-            ly += MOVE_SPEED;
-            redraw = true;
-          }
-          break;
-        case cimg::keyARROWLEFT:
-          if(check_inside(lx - MOVE_SPEED, ly, ZoomBoxW, ZoomBoxH))
-          {
-            lx -= MOVE_SPEED;
-            redraw = true;
-          }
-          break;
-        case cimg::keyARROWRIGHT:
-          if(check_inside(lx + MOVE_SPEED, ly, ZoomBoxW, ZoomBoxH))
-          {
-            lx += MOVE_SPEED;
-            redraw = true;
-          }
-          break;
+        box.lx      = c->lx();
+        box.ly      = c->ly();
+        box.isBlock = c->isFixed() || c->isMacro();
+      }
+      else
+      {
+        box.lx      = placement->lx[i];
+        box.ly      = placement->ly[i];
+        box.isBlock = placement->isFixed[i] || c->isMacro();
+      }
 
-        case cimg::keyZ:
-          if(ZoomBoxW > ZOOM_SPEED 
-          && ZoomBoxH > ZOOM_SPEED)
-          {
-            redraw = true;
-            ZoomBoxW -= ZOOM_SPEED;
-            ZoomBoxH -= ZOOM_SPEED;
-          }
-          break;
-        case cimg::keyX:
-          if(ZoomBoxW <= canvasX_ - ZOOM_SPEED 
-          && ZoomBoxH <= canvasY_ - ZOOM_SPEED)
-          {
-            redraw = true;
-            ZoomBoxW += ZOOM_SPEED;
-            ZoomBoxH += ZOOM_SPEED;
-          }
-          break;
+      box.ux = box.lx + c->dx();
+      box.uy = box.ly + c->dy();
+    }
+  });
 
-        case cimg::keyF:
-          redraw = true;
-          lx = 0;
-          ly = 0;
-          ZoomBoxW = MAX_H; 
-          ZoomBoxH = MAX_W; 
-          break;
+  // Step #1: Bin standard cells into screen tiles
+  std::vector<std::vector<int>> tileCount(numThreads);
 
-        case cimg::keyH:
-          printInterfaceMessage();
-          break;
+  runChunks(numThreads, numCell, [&] (int t, int begin, int end)
+  {
+    tileCount[t].assign(numTile, 0);
+
+    for(int i = begin; i < end; i++)
+    {
+      if( !boxes[i].isBlock )
+        tileCount[t][getTileID(boxes[i])]++;
+    }
+  });
+
+  for(int t = 1; t < numThreads; t++)
+  {
+    for(int tileID = 0; tileID < numTile; tileID++)
+      tileCount[0][tileID] += tileCount[t][tileID];
+  }
+
+  // Step #2: Classify cells (accumulated or drawn one by one)
+  //          and count the cells touching each band
+  std::vector<char> isSmall(numCell);
+  std::vector<std::vector<int>> bandCount(numThreads);
+
+  runChunks(numThreads, numCell, [&] (int t, int begin, int end)
+  {
+    bandCount[t].assign(numBand, 0);
+
+    for(int i = begin; i < end; i++)
+    {
+      const CellBox& box = boxes[i];
+
+      if( box.isBlock )
+        isSmall[i] = false;
+      else
+      {
+        double w = scale_ * (box.ux - box.lx);
+        double h = scale_ * (box.uy - box.ly);
+
+        isSmall[i] = tileCount[0][getTileID(box)] >= denseTile 
+                  || w < LOD_PIXEL_THRESHOLD || h < LOD_PIXEL_THRESHOLD;
       }
-      window_->set_key(); // Flush all key events...
+
+      int lb, ub;
+      getBandRange(box, lb, ub);
+
+      for(int b = lb; b <= ub; b++)
+        bandCount[t][b]++;
     }
-    window_->wait();
+  });
+
+  // Step #3: Spatial bucketing (CSR)
+  std::vector<int> bandStart(numBand + 1, 0);
+
+  for(int b = 0; b < numBand; b++)
+  {
+    bandStart[b + 1] = bandStart[b];
+    for(int t = 0; t < numThreads; t++)
+      bandStart[b + 1] += bandCount[t][b];
+  }
+
+  // bandCount[t][b] := first slot of thread t in band b
+  for(int b = 0; b < numBand; b++)
+  {
+    int pos = bandStart[b];
+    for(int t = 0; t < numThreads; t++)
+    {
+      int count = bandCount[t][b];
+      bandCount[t][b] = pos;
+      pos += count;
+    }
+  }
+
+  std::vector<int> bandCells(bandStart[numBand]);
+
+  runChunks(numThreads, numCell, [&] (int t, int begin, int end)
+  {
+    for(int i = begin; i < end; i++)
+    {
+      int lb, ub;
+      getBandRange(boxes[i], lb, ub);
+
+      for(int b = lb; b <= ub; b++)
+        bandCells[ bandCount[t][b]++ ] = i;
+    }
+  });
+
+  // Step #4: Rasterize bands
+  //          Output does not depend on the number of threads
+  runQueue(numThreads, numBand, [&] (int b)
+  {
+    drawBand(img, b, boxes, isSmall, bandCells.data() + bandStart[b], 
+                                     bandCells.data() + bandStart[b + 1]);
+  });
+}
+
+// Blue -> Cyan -> Green -> Yellow -> Red
+static void heatColor(float t, unsigned char* rgb)
+{
+  t = std::min(std::max(t, 0.0f), 1.0f);
+
+  float r = std::min(std::max(4.0f * t - 2.0f, 0.0f), 1.0f);
+  float g = std::min(std::max(2.0f - std::abs(4.0f * t - 2.0f), 0.0f), 1.0f);
+  float b = std::min(std::max(2.0f - 4.0f * t, 0.0f), 1.0f);
+
+  rgb[0] = static_cast<unsigned char>(255.0f * r);
+  rgb[1] = static_cast<unsigned char>(255.0f * g);
+  rgb[2] = static_cast<unsigned char>(255.0f * b);
+}
+
+void
+Painter::drawHeatmap(CImgObj *img, const BinGrid& grid, float range)
+{
+  // Color look-up table
+  const int numColor = 256;
+
+  unsigned char lut[numColor][3];
+
+  for(int i = 0; i < numColor; i++)
+    heatColor(float(i) / (numColor - 1), lut[i]);
+
+  // Pixels inside the die
+  int pixelLx = std::max(0,            getX(db_->die()->lx()));
+  int pixelUx = std::min(canvasX_ - 1, getX(db_->die()->ux()));
+  int pixelLy = std::max(0,            getY(db_->die()->uy()));
+  int pixelUy = std::min(canvasY_ - 1, getY(db_->die()->ly()));
+
+  if(pixelLx > pixelUx || pixelLy > pixelUy)
+    return;
+
+  // Bin index of each column
+  std::vector<int> columnBin(pixelUx - pixelLx + 1);
+
+  for(int x = pixelLx; x <= pixelUx; x++)
+    columnBin[x - pixelLx] = grid.binX( (x + 0.5 - offsetX_) / scale_ );
+
+  const float alpha = HEATMAP_OPACITY;
+  const float scale = (range > 0.0f) ? (numColor - 1) / range : 0.0f;
+
+  int numRow     = pixelUy - pixelLy + 1;
+  int numThreads = std::max(1, std::min(db_->numThreads(), numRow));
+
+  // Each row is written by only one thread
+  runQueue(numThreads, numRow, [&] (int r)
+  {
+    const int y = pixelLy + r;
+
+    int binY = grid.binY( maxHeight_ - (y + 0.5 - offsetY_) / scale_ );
+
+    const float* row = grid.values().data() + binY * grid.numBinX();
+
+    for(int ch = 0; ch < 3; ch++)
+    {
+      unsigned char* pixel = img->data(0, y, 0, ch);
+
+      for(int x = pixelLx; x <= pixelUx; x++)
+      {
+        int level = std::min(static_cast<int>(row[columnBin[x - pixelLx]] * scale), numColor - 1);
+
+        pixel[x] = static_cast<unsigned char>(pixel[x] * (1.0f - alpha) 
+                                            + lut[level][ch] * alpha + 0.5f);
+      }
+    }
+  });
+}
+
+void
+Painter::drawScene(CImgObj *img)
+{
+  drawDie(img);
+
+  if(heatmap_ != nullptr)
+    drawHeatmap(img, *heatmap_, heatmapRange_);
+  else
+    drawCells(img);
+}
+
+Status
+Painter::drawDensity(const std::string& fileName, int width, int height, 
+                     int numBinX, int numBinY, bool macroAware)
+{
+  auto t1 = std::chrono::steady_clock::now();
+
+  BinGrid grid(db_);
+  RTree   blocks(db_);
+
+  if(macroAware)
+  {
+    if(Status status = blocks.build(); !status)
+      return status;
   }
-  exit(0);
+
+  if(Status status = grid.computeDensity(numBinX, numBinY, macroAware ? &blocks : nullptr); !status)
+    return status;
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+
+  coutf("Density (%dx%d bins) Max : %.3f Avg : %.3f (%.4f s)\n", 
+         numBinX, numBinY, grid.maxValue(), grid.avgValue(), runtime.count());
+
+  // 100% utilization is drawn with the hottest color
+  heatmap_      = &grid;
+  heatmapRange_ = 1.0f;
+
+  if(fileName.empty())
+    drawChip();
+  else
+    drawChip(fileName, width, height);
+
+  heatmap_ = nullptr;
+
+  return Status();
+}
+
+Status
+Painter::drawRudy(const std::string& fileName, int width, int height, 
+                  int numBinX, int numBinY)
+{
+  auto t1 = std::chrono::steady_clock::now();
+
+  BinGrid grid(db_);
+
+  if(Status status = grid.computeRudy(numBinX, numBinY); !status)
+    return status;
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+
+  coutf("RUDY (%dx%d bins) Max : %.3f Avg : %.3f (%.4f s)\n", 
+         numBinX, numBinY, grid.maxValue(), grid.avgValue(), runtime.count());
+
+  heatmap_      = &grid;
+  heatmapRange_ = grid.maxValue();
+
+  if(fileName.empty())
+    drawChip();
+  else
+    drawChip(fileName, width, height);
+
+  heatmap_ = nullptr;
+
+  return Status();
+}
+
+void
+Painter::drawNets(const std::string& fileName, int width, int height,
+                  int maxFanout, bool drawBBox, 
+                  const std::vector<std::string>& netNames)
+{
+  buildNetOverlay(maxFanout, drawBBox, netNames);
+
+  if(fileName.empty())
+    drawChip();
+  else
+    drawChip(fileName, width, height);
+
+  overlay_ = NetOverlay();
+}
+
+void
+Painter::buildNetOverlay(int maxFanout, bool drawBBox, 
+                         const std::vector<std::string>& netNames)
+{
+  overlay_ = NetOverlay();
+
+  overlay_.enable   = true;
+  overlay_.drawBBox = drawBBox;
+
+  std::vector<const dbNet*>& nets = overlay_.nets;
+
+  // Step #1: Select nets
+  int numCulled = 0;
+
+  if(!netNames.empty())
+  {
+    for(auto& netName : netNames)
+    {
+      int netID = db_->findNetID(netName);
+
+      if(netID < 0)
+        std::cout << "Net " << netName << " does not exist." << std::endl;
+      else if(db_->nets()[netID]->pins().size() < 2)
+        std::cout << "Net " << netName << " has less than 2 pins (skipped)." << std::endl;
+      else
+        nets.push_back( db_->nets()[netID] );
+    }
+  }
+  else
+  {
+    for(auto net : db_->nets())
+    {
+      if(net->isTie() || net->pins().size() < 2)
+        continue;
+
+      if(static_cast<int>( net->pins().size() ) > maxFanout)
+        numCulled++;
+      else
+        nets.push_back(net);
+    }
+  }
+
+  int numNet = nets.size();
+
+  // Step #2: Bounding box of nets
+  overlay_.netLx.resize(numNet);
+  overlay_.netLy.resize(numNet);
+  overlay_.netUx.resize(numNet);
+  overlay_.netUy.resize(numNet);
+
+  for(int i = 0; i < numNet; i++)
+  {
+    int netLx = INT_MAX;
+    int netLy = INT_MAX;
+    int netUx = INT_MIN;
+    int netUy = INT_MIN;
+
+    for(const dbPin* pin : nets[i]->pins())
+    {
+      int x, y;
+      pinLocation(pin, x, y);
+
+      netLx = std::min(netLx, x);
+      netLy = std::min(netLy, y);
+      netUx = std::max(netUx, x);
+      netUy = std::max(netUy, y);
+    }
+
+    overlay_.netLx[i] = netLx;
+    overlay_.netLy[i] = netLy;
+    overlay_.netUx[i] = netUx;
+    overlay_.netUy[i] = netUy;
+  }
+
+  // Step #3: Bucket of each net
+  const int64_t dieLx = db_->die()->lx();
+  const int64_t dieLy = db_->die()->ly();
+  const int64_t dieW  = std::max(1, db_->die()->ux() - db_->die()->lx());
+  const int64_t dieH  = std::max(1, db_->die()->uy() - db_->die()->ly());
+
+  overlay_.numLevel = NET_OVERLAY_MAX_LEVEL + 1;
+  overlay_.levelStart.resize(overlay_.numLevel + 1);
+  overlay_.levelStart[0] = 0;
+
+  for(int l = 0; l < overlay_.numLevel; l++)
+    overlay_.levelStart[l + 1] = overlay_.levelStart[l] + (1 << l) * (1 << l);
+
+  std::vector<int> netBucket(numNet);
+
+  for(int i = 0; i < numNet; i++)
+  {
+    int64_t w = overlay_.netUx[i] - overlay_.netLx[i];
+    int64_t h = overlay_.netUy[i] - overlay_.netLy[i];
+
+    int l = 0;
+    while(l + 1 < overlay_.numLevel && (w << (l + 1)) <= dieW 
+                                    && (h << (l + 1)) <= dieH)
+      l++;
+
+    int64_t n  = 1 << l;
+    int64_t bx = (overlay_.netLx[i] - dieLx) * n / dieW;
+    int64_t by = (overlay_.netLy[i] - dieLy) * n / dieH;
+
+    bx = std::min(std::max(bx, int64_t(0)), n - 1);
+    by = std::min(std::max(by, int64_t(0)), n - 1);
+
+    netBucket[i] = overlay_.levelStart[l] + by * n + bx;
+  }
+
+  // Step #4: CSR
+  int numBucket = overlay_.levelStart[overlay_.numLevel];
+
+  overlay_.bucketStart.assign(numBucket + 1, 0);
+  overlay_.bucketNets.resize(numNet);
+
+  for(int i = 0; i < numNet; i++)
+    overlay_.bucketStart[netBucket[i] + 1]++;
+
+  for(int b = 0; b < numBucket; b++)
+    overlay_.bucketStart[b + 1] += overlay_.bucketStart[b];
+
+  std::vector<int> fill(overlay_.bucketStart.begin(), overlay_.bucketStart.end() - 1);
+
+  for(int i = 0; i < numNet; i++)
+    overlay_.bucketNets[ fill[netBucket[i]]++ ] = i;
+
+  std::cout << "Net overlay : " << numNet << " nets";
+  if(netNames.empty())
+    std::cout << " (" << numCulled << " nets with fanout > " << maxFanout << " are culled)";
+  std::cout << std::endl;
+}
+
+int
+Painter::drawNetOverlay(CImgObj *img, double viewLx,     double viewLy,
+                                      double viewScaleX, double viewScaleY)
+{
+  // Viewport (dbu)
+  double vLx = (viewLx - offsetX_) / scale_;
+  double vUx = (viewLx + img->width()  / viewScaleX - offsetX_) / scale_;
+  double vUy = maxHeight_ - (viewLy - offsetY_) / scale_;
+  double vLy = maxHeight_ - (viewLy + img->height() / viewScaleY - offsetY_) / scale_;
+
+  const double dieLx = db_->die()->lx();
+  const double dieLy = db_->die()->ly();
+  const double dieW  = std::max(1, db_->die()->ux() - db_->die()->lx());
+  const double dieH  = std::max(1, db_->die()->uy() - db_->die()->ly());
+
+  auto imgX = [&] (int x) { return static_cast<float>( (toScreenX(x) - viewLx) * viewScaleX ); };
+  auto imgY = [&] (int y) { return static_cast<float>( (toScreenY(y) - viewLy) * viewScaleY ); };
+
+  auto addLine = [] (std::vector<float>& buffer, float x1, float y1, float x2, float y2)
+  {
+    buffer.push_back(x1);
+    buffer.push_back(y1);
+    buffer.push_back(x2);
+    buffer.push_back(y2);
+  };
+
+  std::vector<float> lineBuffer;
+
+  int numDrawn = 0;
+
+  for(int l = 0; l < overlay_.numLevel; l++)
+  {
+    int n = 1 << l;
+
+    // A net of this level reaches the next bucket at most
+    auto bucketRange = [n] (double lower, double upper, double start, double size, int& b0, int& b1)
+    {
+      b0 = static_cast<int>( std::floor((lower - start) * n / size) ) - 1;
+      b1 = static_cast<int>( std::floor((upper - start) * n / size) );
+      b0 = std::min(std::max(b0, 0), n - 1);
+      b1 = std::min(std::max(b1, 0), n - 1);
+    };
+
+    int bx0, bx1, by0, by1;
+    bucketRange(vLx, vUx, dieLx, dieW, bx0, bx1);
+    bucketRange(vLy, vUy, dieLy, dieH, by0, by1);
+
+    for(int by = by0; by <= by1; by++)
+    {
+      for(int bx = bx0; bx <= bx1; bx++)
+      {
+        int b = overlay_.levelStart[l] + by * n + bx;
+
+        for(int k = overlay_.bucketStart[b]; k < overlay_.bucketStart[b + 1]; k++)
+        {
+          int i = overlay_.bucketNets[k];
+
+          if(overlay_.netUx[i] < vLx || overlay_.netLx[i] > vUx 
+          || overlay_.netUy[i] < vLy || overlay_.netLy[i] > vUy)
+            continue;
+
+          numDrawn++;
+
+          if(overlay_.drawBBox)
+          {
+            float x1 = imgX(overlay_.netLx[i]);
+            float x2 = imgX(overlay_.netUx[i]);
+            float y1 = imgY(overlay_.netLy[i]);
+            float y2 = imgY(overlay_.netUy[i]);
+
+            addLine(lineBuffer, x1, y1, x2, y1);
+            addLine(lineBuffer, x2, y1, x2, y2);
+            addLine(lineBuffer, x2, y2, x1, y2);
+            addLine(lineBuffer, x1, y2, x1, y1);
+            continue;
+          }
+
+          // Flylines : driver -> sinks 
+          const std::vector<dbPin*>& pins = overlay_.nets[i]->pins();
+
+          const dbPin* driver = pins[0];
+
+          for(const dbPin* pin : pins)
+          {
+            bool isDriver = pin->isExternal() 
+                          ? (pin->io()     != nullptr && pin->io()->direction()     == INPUT )
+                          : (pin->lefPin() != nullptr && pin->lefPin()->direction() == OUTPUT);
+            if(isDriver)
+            {
+              driver = pin;
+              break;
+            }
+          }
+
+          int dx, dy;
+          pinLocation(driver, dx, dy);
+
+          for(const dbPin* pin : pins)
+          {
+            if(pin == driver)
+              continue;
+
+            int x, y;
+            pinLocation(pin, x, y);
+
+            addLine(lineBuffer, imgX(dx), imgY(dy), imgX(x), imgY(y));
+          }
+        }
+      }
+    }
+  }
+
+  drawLines(img, lineBuffer, NET_LINE_COLOR);
+
+  return numDrawn;
+}
+
+void
+Painter::drawLines(CImgObj *img, const std::vector<float>& lineBuffer, Color color)
+{
+  const int   width  = img->width();
+  const int   height = img->height();
+  const float maxX   = width  - 1;
+  const float maxY   = height - 1;
+
+  // Lines are rasterized into a mask first (one byte per pixel),
+  // then the mask is composited into the three color planes in one pass
+  std::vector<unsigned char> mask(static_cast<size_t>(width) * height, 0);
+
+  for(size_t i = 0; i + 3 < lineBuffer.size(); i += 4)
+  {
+    float x1 = lineBuffer[i    ];
+    float y1 = lineBuffer[i + 1];
+    float x2 = lineBuffer[i + 2];
+    float y2 = lineBuffer[i + 3];
+
+    // Liang-Barsky clipping to the image
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+
+    float p[4] = {  -dx,       dx,  -dy,       dy };
+    float q[4] = {   x1, maxX - x1,  y1, maxY - y1};
+
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+
+    bool isVisible = true;
+
+    for(int k = 0; k < 4 && isVisible; k++)
+    {
+      if(p[k] == 0.0f)
+        isVisible = (q[k] >= 0.0f);
+      else
+      {
+        float r = q[k] / p[k];
+        if(p[k] < 0.0f)
+          t0 = std::max(t0, r);
+        else
+          t1 = std::min(t1, r);
+        isVisible = (t0 <= t1);
+      }
+    }
+
+    if(!isVisible)
+      continue;
+
+    float sx = x1 + t0 * dx;
+    float sy = y1 + t0 * dy;
+    float ex = x1 + t1 * dx;
+    float ey = y1 + t1 * dy;
+
+    // Bresenham (endpoints are inside the image after clipping)
+    int px = std::min(std::max(static_cast<int>(sx + 0.5f), 0), width  - 1);
+    int py = std::min(std::max(static_cast<int>(sy + 0.5f), 0), height - 1);
+    int qx = std::min(std::max(static_cast<int>(ex + 0.5f), 0), width  - 1);
+    int qy = std::min(std::max(static_cast<int>(ey + 0.5f), 0), height - 1);
+
+    int adx =  std::abs(qx - px);
+    int ady = -std::abs(qy - py);
+    int stepX = (px < qx) ? 1 : -1;
+    int stepY = (py < qy) ? width : -width;
+
+    int    err    = adx + ady;
+    size_t offset = static_cast<size_t>(py) * width + px;
+    size_t last   = static_cast<size_t>(qy) * width + qx;
+
+    while(true)
+    {
+      mask[offset] = 1;
+
+      if(offset == last)
+        break;
+
+      int e2 = 2 * err;
+
+      if(e2 >= ady)
+      {
+        err    += ady;
+        offset += stepX;
+      }
+      if(e2 <= adx)
+      {
+        err    += adx;
+        offset += stepY;
+      }
+    }
+  }
+
+  for(int ch = 0; ch < 3; ch++)
+  {
+    unsigned char* plane = img->data(0, 0, 0, ch);
+
+    for(size_t offset = 0; offset < mask.size(); offset++)
+    {
+      if(mask[offset])
+        plane[offset] = color[ch];
+    }
+  }
+}
+
+void
+Painter::buildPyramid(const CImgObj& img)
+{
+  pyramid_.clear();
+
+  int width  = img.width();
+  int height = img.height();
+
+  // Levels coarser than the window are never used
+  while(true)
+  {
+    PyramidLevel level;
+    level.width    = width;
+    level.height   = height;
+    level.numTileX = (width  + PYRAMID_TILE_SIZE - 1) / PYRAMID_TILE_SIZE;
+    level.numTileY = (height + PYRAMID_TILE_SIZE - 1) / PYRAMID_TILE_SIZE;
+    level.tiles.resize(level.numTileX * level.numTileY);
+
+    pyramid_.push_back(std::move(level));
+
+    if(width <= WINDOW_W && height <= WINDOW_H)
+      break;
+
+    width  = (width  + 1) / 2;
+    height = (height + 1) / 2;
+  }
+
+  for(int k = 0; k < pyramid_.size(); k++)
+  {
+    PyramidLevel& level = pyramid_[k];
+
+    int numTile    = level.numTileX * level.numTileY;
+    int numThreads = std::max(1, std::min(db_->numThreads(), numTile));
+
+    runQueue(numThreads, numTile, [&] (int tileID)
+    {
+      int tileLx = (tileID % level.numTileX) * PYRAMID_TILE_SIZE;
+      int tileLy = (tileID / level.numTileX) * PYRAMID_TILE_SIZE;
+      int tileW  = std::min(PYRAMID_TILE_SIZE, level.width  - tileLx);
+      int tileH  = std::min(PYRAMID_TILE_SIZE, level.height - tileLy);
+
+      CImgObj& tile = level.tiles[tileID];
+
+      if(k == 0)
+      {
+        tile = img.get_crop(tileLx, tileLy, tileLx + tileW - 1, tileLy + tileH - 1);
+        return;
+      }
+
+      // 2x2 box filter of the previous level
+      const PyramidLevel& prev = pyramid_[k - 1];
+
+      auto prevPixel = [&prev] (int x, int y, int ch) -> int
+      {
+        const CImgObj& prevTile 
+          = prev.tiles[(y / PYRAMID_TILE_SIZE) * prev.numTileX + (x / PYRAMID_TILE_SIZE)];
+        return prevTile(x % PYRAMID_TILE_SIZE, y % PYRAMID_TILE_SIZE, 0, ch);
+      };
+
+      tile.assign(tileW, tileH, 1, 3);
+
+      for(int ch = 0; ch < 3; ch++)
+      {
+        for(int y = 0; y < tileH; y++)
+        {
+          int y0 = 2 * (tileLy + y);
+          int y1 = std::min(y0 + 1, prev.height - 1);
+
+          for(int x = 0; x < tileW; x++)
+          {
+            int x0 = 2 * (tileLx + x);
+            int x1 = std::min(x0 + 1, prev.width - 1);
+
+            int sum = prevPixel(x0, y0, ch) + prevPixel(x1, y0, ch)
+                    + prevPixel(x0, y1, ch) + prevPixel(x1, y1, ch);
+
+            tile(x, y, 0, ch) = static_cast<unsigned char>((sum + 2) / 4);
+          }
+        }
+      }
+    });
+  }
+}
+
+CImgObj
+Painter::composeView(int lx, int ly, int w, int h)
+{
+  int windowW = (window_ != nullptr) ? window_->width()  : WINDOW_W;
+  int windowH = (window_ != nullptr) ? window_->height() : WINDOW_H;
+
+  // Coarsest level which still has one pixel per window pixel
+  int k = 0;
+
+  while(k + 1 < pyramid_.size() 
+     && (w >> (k + 1)) >= windowW 
+     && (h >> (k + 1)) >= windowH)
+    k++;
+
+  const PyramidLevel& level = pyramid_[k];
+
+  int viewLx = lx >> k;
+  int viewLy = ly >> k;
+  int viewW  = std::max(1, w >> k);
+  int viewH  = std::max(1, h >> k);
+
+  CImgObj view(viewW, viewH, 1, 3, 255);
+
+  int tileLx = std::max(0, viewLx / PYRAMID_TILE_SIZE);
+  int tileLy = std::max(0, viewLy / PYRAMID_TILE_SIZE);
+  int tileUx = std::min(level.numTileX - 1, (viewLx + viewW - 1) / PYRAMID_TILE_SIZE);
+  int tileUy = std::min(level.numTileY - 1, (viewLy + viewH - 1) / PYRAMID_TILE_SIZE);
+
+  for(int ty = tileLy; ty <= tileUy; ty++)
+  {
+    for(int tx = tileLx; tx <= tileUx; tx++)
+    {
+      view.draw_image(tx * PYRAMID_TILE_SIZE - viewLx, 
+                      ty * PYRAMID_TILE_SIZE - viewLy, 
+                      level.tiles[ty * level.numTileX + tx]);
+    }
+  }
+
+  return view;
+}
+
+void
+Painter::drawChip()
+{
+#if cimg_display == 0
+  std::cout << "Interactive mode is not available (built without X11)." << std::endl;
+  std::cout << "Please use draw_chip -o <file> instead." << std::endl;
+#else
+  init();
+  drawScene(img_);
+  buildPyramid(*img_);
+
+  // Level 0 of the pyramid has the same pixels
+  delete img_;
+  img_ = nullptr;
+
+  show();
+
+  pyramid_.clear();
+#endif
+}
+
+void
+Painter::drawChip(const std::string& fileName, int width, int height)
+{
+  auto t1 = std::chrono::steady_clock::now();
+
+  init(width, height);
+
+  // Rasterize into the in-memory buffer only (no CImgDisplay)
+  CImgObj img(canvasX_, canvasY_, 1, 3, 255);
+
+  drawScene(&img);
+
+  if(overlay_.enable)
+  {
+    int numDrawn = drawNetOverlay(&img, 0.0, 0.0, 1.0, 1.0);
+    std::cout << "Draw " << numDrawn << " nets" << std::endl;
+  }
+
+  try
+  {
+    img.save( fileName.c_str() );
+  }
+  catch(CImgException& e)
+  {
+    std::cout << "Failed to write " << fileName << std::endl;
+    return;
+  }
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+
+  std::cout << "Write " << fileName << " (" << canvasX_ << "x" << canvasY_ << ") ";
+  std::cout << "with " << db_->numThreads() << " threads ";
+  std::cout << "in " << runtime.count() << " s" << std::endl;
+}
+
+void
+Painter::benchDrawChip(int width, int height)
+{
+  init(width, height);
+
+  std::cout << "Frame time of drawCells (" << canvasX_ << "x" << canvasY_ << ")" << std::endl;
+  std::cout << "  Threads   Time (s)   Speedup   Same as 1-thread" << std::endl;
+
+  CImgObj background(canvasX_, canvasY_, 1, 3, 255);
+  drawDie(&background);
+
+  CImgObj reference;
+
+  double baseTime = 0.0;
+
+  for(int numThreads = 1; numThreads <= 32; numThreads *= 2)
+  {
+    CImgObj img(background);
+
+    auto t1 = std::chrono::steady_clock::now();
+    drawCells(&img, numThreads);
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> runtime = t2 - t1;
+
+    if(numThreads == 1)
+    {
+      baseTime  = runtime.count();
+      reference = img;
+    }
+
+    coutf("  %7d   %8.4f   %7.2f   %s\n", numThreads, 
+                                            runtime.count(), 
+                                            baseTime / runtime.count(),
+                                            img == reference ? "yes" : "NO");
+  }
+}
+
+void
+Painter::prepareCanvas(int width, int height)
+{
+  init(width, height);
+
+  delete background_;
+  delete img_;
+
+  background_ = new CImgObj(canvasX_, canvasY_, 1, 3, 255);
+  drawDie(background_);
+
+  img_ = new CImgObj(*background_);
+}
+
+void
+Painter::resetCanvas()
+{
+  *img_ = *background_;
+}
+
+void
+Painter::rasterCells(int numThreads)
+{
+  drawCells(img_, numThreads);
+}
+
+void
+Painter::drawTrajectory(const std::vector<std::string>& defFiles,
+                        const std::string& seqName,
+                        const std::string& gifName,
+                        int width, int height, int delay)
+{
+  auto t1 = std::chrono::steady_clock::now();
+
+  init(width, height);
+
+  const int numFrame = defFiles.size();
+
+  if(numFrame == 0)
+  {
+    std::cout << "No DEF for the trajectory..." << std::endl;
+    return;
+  }
+
+  // Die does not move
+  CImgObj background(canvasX_, canvasY_, 1, 3, 255);
+  drawDie(&background);
+
+  GifWriter gif(canvasX_, canvasY_, delay);
+
+  std::vector<std::vector<unsigned char>> gifFrames(numFrame);
+
+  // One frame per thread,
+  // the rest of the threads are given to drawCells
+  const int numThreads  = std::max(1, std::min(db_->numThreads(), numFrame));
+  const int cellThreads = std::max(1, db_->numThreads() / numThreads);
+
+  std::vector<double> parseTime(numFrame, 0.0);
+  std::vector<double> renderTime(numFrame, 0.0);
+
+  std::vector<char> isWritten(numFrame, true);
+  std::vector<std::string> parseErrors(numFrame);           // Empty if the frame is parsed
+
+  dbPlacement lastPlacement;
+
+  runQueue(numThreads, numFrame, [&] (int f)
+  {
+    dbPlacement placement;
+
+    auto p1 = std::chrono::steady_clock::now();
+
+    Status status = db_->readDefPlacement(defFiles[f], placement);
+
+    auto p2 = std::chrono::steady_clock::now();
+
+    parseTime[f] = std::chrono::duration<double>(p2 - p1).count();
+
+    if(!status)
+    {
+      parseErrors[f] = status.message();
+      return;
+    }
+
+    CImgObj img(background);
+    drawCells(&img, cellThreads, &placement);
+
+    if(!seqName.empty())
+    {
+      try
+      {
+        img.save(seqName.c_str(), f, 4); // xx.png -> xx_0000.png
+      }
+      catch(CImgException& e)
+      {
+        isWritten[f] = false;
+      }
+    }
+
+    if(!gifName.empty())
+      gifFrames[f] = gif.encodeFrame(img);
+
+    auto p3 = std::chrono::steady_clock::now();
+
+    renderTime[f] = std::chrono::duration<double>(p3 - p2).count();
+
+    if(f == numFrame - 1)
+      lastPlacement = std::move(placement);
+  });
+
+  int lastFrame = -1;
+
+  // Frames in the image sequence (xx_0000.png ~)
+  int numWritten   = 0;
+  int firstWritten = -1;
+  int lastWritten  = -1;
+
+  for(int f = 0; f < numFrame; f++)
+  {
+    if(!parseErrors[f].empty())
+    {
+      std::cout << "Skipped frame " << f << " : " << parseErrors[f] << std::endl;
+      continue;
+    }
+
+    lastFrame = f;
+
+    if(!isWritten[f])
+    {
+      std::cout << "Failed to write frame " << f << " (" << defFiles[f] << ")" << std::endl;
+      continue;
+    }
+
+    if(firstWritten < 0)
+      firstWritten = f;
+
+    lastWritten = f;
+    numWritten++;
+  }
+
+  // No GIF without a parsed frame
+  bool isGifWritten = false;
+
+  if(!gifName.empty() && lastFrame >= 0)
+  {
+    isGifWritten = gif.write(gifName, gifFrames);
+
+    if(!isGifWritten)
+      std::cout << "Failed to write " << gifName << std::endl;
+  }
+
+  // DB is left at the last parsed frame (same as reading the DEFs one by one)
+  if(lastFrame >= 0 && lastFrame < numFrame - 1)
+    (void)db_->readDefPlacement(defFiles[lastFrame], lastPlacement);
+
+  if(lastFrame >= 0)
+  {
+    if(Status status = db_->applyPlacement(lastPlacement); !status)
+      std::cout << status.message() << std::endl;
+  }
+
+  auto t2 = std::chrono::steady_clock::now();
+
+  std::chrono::duration<double> runtime = t2 - t1;
+
+  double sumParse  = 0.0;
+  double sumRender = 0.0;
+
+  for(int f = 0; f < numFrame; f++)
+  {
+    sumParse  += parseTime[f];
+    sumRender += renderTime[f];
+  }
+
+  std::cout << "Draw " << numFrame << " frames (" << canvasX_ << "x" << canvasY_ << ") ";
+  std::cout << "with " << numThreads << " threads in " << runtime.count() << " s" << std::endl;
+
+  coutf("  Parse  (placement, sum of threads) : %.4f s\n", sumParse);
+  coutf("  Render (+ encode,  sum of threads) : %.4f s\n", sumRender);
+
+  if(!seqName.empty() && numWritten == 0)
+    std::cout << "  No frame is written to " << seqName << std::endl;
+  else if(!seqName.empty())
+  {
+    char first[1024];
+    char last[1024];
+    cimg::number_filename(seqName.c_str(), firstWritten, 4, first);
+    cimg::number_filename(seqName.c_str(), lastWritten,  4, last);
+
+    // Numbers of the skipped / failed frames are missing in the range
+    const int numRange = lastWritten - firstWritten + 1;
+
+    if(numWritten == 1)
+      coutf("  Write %s\n", first);
+    else if(numWritten == numRange)
+      coutf("  Write %s ~ %s\n", first, last);
+    else
+      coutf("  Write %s ~ %s (%d of %d, the others are missing)\n", first, last, numWritten, numRange);
+  }
+
+  if(isGifWritten)
+    std::cout << "  Write " << gifName << std::endl;
+  else if(!gifName.empty() && lastFrame < 0)
+    std::cout << "  No frame is written to " << gifName << std::endl;
+}
+
+void 
+Painter::show()
+{
+  int viewX = 0;
+  int viewY = 0;
+
+  int ZoomBoxW = MAX_H; 
+  int ZoomBoxH = MAX_W; 
+
+  bool redraw = false;
+
+  int lx = 0;
+  int ly = 0;
+
+  window_ = new CImgDisplay(WINDOW_W, WINDOW_H, "Placement GUI");
+
+  // The scene does not change during the interactive mode,
+  // so pan/zoom only composes cached tiles of the pyramid
+  CImgObj ZoomBox = composeView(lx, ly, ZoomBoxW, ZoomBoxH);
+  ZoomBox.resize(*window_);
+
+  // Nets are not in the pyramid, they are drawn on the window image
+  // (only the nets inside the zoom box)
+  auto drawOverlay = [&] ()
+  {
+    if(overlay_.enable)
+    {
+      drawNetOverlay(&ZoomBox, lx, ly, double(ZoomBox.width() ) / ZoomBoxW, 
+                                       double(ZoomBox.height()) / ZoomBoxH);
+    }
+  };
+
+  drawOverlay();
+
+  printInterfaceMessage();
+
+  // Interactive Mode //
+  while(!window_->is_closed() && !window_->is_keyESC()
+                              && !window_->is_keyQ())
+  {
+    if(redraw)
+    {
+      ZoomBox = composeView(lx, ly, ZoomBoxW, ZoomBoxH);
+      ZoomBox.resize(*window_);
+      drawOverlay();
+      redraw = false;
+    }
+
+    ZoomBox.display(*window_);
+
+    if(window_->key())
+    {
+      switch(window_->key())
+      {
+        case cimg::keyARROWUP:
+          if(check_inside(lx, ly - MOVE_SPEED, ZoomBoxW, ZoomBoxH))
+          {
+            ly -= MOVE_SPEED;
+            redraw = true;
+          }
+          break;
+        case cimg::keyARROWDOWN:
+          if(check_inside(lx, ly + MOVE_SPEED, ZoomBoxW, ZoomBoxH))
+          {
+            ly += MOVE_SPEED;
+            redraw = true;
+          }
+          break;
+        case cimg::keyARROWLEFT:
+          if(check_inside(lx - MOVE_SPEED, ly, ZoomBoxW, ZoomBoxH))
+          {
+            lx -= MOVE_SPEED;
+            redraw = true;
+          }
+          break;
+        case cimg::keyARROWRIGHT:
+          if(check_inside(lx + MOVE_SPEED, ly, ZoomBoxW, ZoomBoxH))
+          {
+            lx += MOVE_SPEED;
+            redraw = true;
+          }
+          break;
+
+        case cimg::keyZ:
+          if(ZoomBoxW > ZOOM_SPEED 
+          && ZoomBoxH > ZOOM_SPEED)
+          {
+            redraw = true;
+            ZoomBoxW -= ZOOM_SPEED;
+            ZoomBoxH -= ZOOM_SPEED;
+          }
+          break;
+        case cimg::keyX:
+          if(ZoomBoxW <= canvasX_ - ZOOM_SPEED 
+          && ZoomBoxH <= canvasY_ - ZOOM_SPEED)
+          {
+            redraw = true;
+            ZoomBoxW += ZOOM_SPEED;
+            ZoomBoxH += ZOOM_SPEED;
+          }
+          break;
+
+        case cimg::keyF:
+          redraw = true;
+          lx = 0;
+          ly = 0;
+          ZoomBoxW = MAX_H; 
+          ZoomBoxH = MAX_W; 
+          break;
+
+        case cimg::keyH:
+          printInterfaceMessage();
+          break;
+      }
+      window_->set_key(); // Flush all key events...
+    }
+    window_->wait();
+  }
+
+  delete window_;
+  window_ = nullptr;
 }
 
 } // namespace Graphic
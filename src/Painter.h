@@ -1,8 +1,11 @@
 #pragma once
 
 #include <memory>
-#include "CImg.h"
+#include <string>
+#include <vector>
+#include "CImgFwd.h"
 #include "LefDefParser.h"
+#include "BinGrid.h"
 
 namespace Graphic
 {
@@ -19,10 +22,10 @@ static const unsigned char white[]  = {255, 255, 255},
                            aqua[]   = {204, 204, 255};
 
 using namespace LefDefDB;
-using namespace cimg_library;
 
 typedef const unsigned char* Color;
-typedef CImg<unsigned char> CImgObj;
+typedef cimg_library::CImg<unsigned char> CImgObj;
+typedef cimg_library::CImgDisplay         CImgDisplay;
 
 class Painter 
 {
@@ -31,12 +34,48 @@ class Painter
     Painter();
 		Painter(std::shared_ptr<LefDefParser> db) : Painter()
 		{ db_ = db; }
-
-    void drawChip();
+    ~Painter();
+
+    void drawChip();                                        // Interactive Mode (needs X11)
+    void drawChip(const std::string& fileName,              // Headless Mode
+                  int width, int height);                   // (write the image file without display)
+    void benchDrawChip(int width, int height);              // Report frame time for 1 ~ 32 threads
+
+    // Cell rasterizer alone on a headless canvas (for microbenchmarks)
+    // The die is drawn once as the background, so a frame is resetCanvas + rasterCells.
+    void prepareCanvas(int width, int height);              // Canvas size (including offsets)
+    void resetCanvas  ();                                   // Background only
+    void rasterCells  (int numThreads);                     // Every cell on the canvas
+
+    // Heatmap over the die (Interactive Mode if fileName is empty)
+    Status drawDensity(const std::string& fileName,         // Cell density
+                       int width,   int height,
+                       int numBinX, int numBinY,
+                       bool macroAware = false);            // Fixed macros are taken out of the bin area
+    Status drawRudy   (const std::string& fileName,         // RUDY congestion
+                       int width,   int height,
+                       int numBinX, int numBinY);
+
+    // Cells + Net overlay (Interactive Mode if fileName is empty)
+    void drawNets   (const std::string& fileName,
+                     int width,   int height,
+                     int maxFanout,                         // Nets with more pins are culled
+                     bool drawBBox,                         // Bounding box instead of flylines
+                     const std::vector<std::string>& netNames); // Only these nets (all if empty)
+
+    // Placement trajectory (one frame per DEF, headless)
+    // Frames are parsed and rasterized in parallel, and written
+    // as numbered images and / or an animated GIF.
+    void drawTrajectory(const std::vector<std::string>& defFiles,
+                        const std::string& seqName,         // xx.png -> xx_0000.png, ... (none if empty)
+                        const std::string& gifName,         // No GIF if empty
+                        int width, int height,
+                        int delay);                         // GIF frame delay (1/100 s)
 
   private:
 
 		void init();
+		void init(int width, int height);                       // Canvas size (including offsets)
 
     // LefDef Parser
     std::shared_ptr<LefDefParser> db_;
@@ -54,10 +93,65 @@ class Painter
     // Scaling Factor to fit the window size
 
     //CImg library
-    CImgObj*       canvas_;
-    CImgObj*          img_;
+    CImgObj*          img_;                                 // Full resolution placement image
+    CImgObj*   background_;                                 // Die only (prepareCanvas)
     CImgDisplay*   window_;
 
+    // Multi-resolution Image Pyramid (Interactive Mode)
+    // Level 0 is the full resolution image, Level k is downsampled by 2^k.
+    // Each level is stored as PYRAMID_TILE_SIZE x PYRAMID_TILE_SIZE tiles,
+    // so pan/zoom only composes the tiles inside the zoom box.
+    struct PyramidLevel
+    {
+      int width;
+      int height;
+      int numTileX;
+      int numTileY;
+      std::vector<CImgObj> tiles;                           // Row-major
+    };
+
+    std::vector<PyramidLevel> pyramid_;
+
+    // Net Overlay
+    // Each net is put into one bucket of a hierarchical grid over the die:
+    // the finest level whose bucket is not smaller than the net bounding box,
+    // at the bucket of its lower-left corner. So a net overlaps only
+    // its bucket and the next ones, and a viewport query visits
+    // O(visible buckets) without duplicates.
+    struct NetOverlay
+    {
+      bool enable   = false;
+      bool drawBBox = false;
+
+      int numLevel  = 0;                                    // Level l has 2^l x 2^l buckets
+
+      std::vector<const dbNet*> nets;
+      std::vector<int> netLx;                               // Bounding box of nets (dbu)
+      std::vector<int> netLy;
+      std::vector<int> netUx;
+      std::vector<int> netUy;
+
+      std::vector<int> levelStart;                          // First bucket of each level
+      std::vector<int> bucketStart;                         // CSR
+      std::vector<int> bucketNets;
+    };
+
+    NetOverlay overlay_;
+
+    void buildNetOverlay(int maxFanout, bool drawBBox, 
+                         const std::vector<std::string>& netNames);
+
+    // view : canvas pixel (viewLx, viewLy) is img pixel (0, 0),
+    //        one canvas pixel is (viewScaleX x viewScaleY) img pixels
+    int  drawNetOverlay (CImgObj *img, double viewLx,     double viewLy,   // Returns the number of drawn nets
+                                       double viewScaleX, double viewScaleY);
+
+    // Draw all lines (x1, y1, x2, y2 in img pixel) of the buffer in one pass
+    void drawLines      (CImgObj *img, const std::vector<float>& lineBuffer, Color color);
+
+    void    buildPyramid(const CImgObj& img);               // Rasterized once per drawChip()
+    CImgObj composeView (int lx, int ly, int w, int h);     // Zoom box in level 0 coordinates
+
     // Draw Objects
     int getX(int dbX);
     int getY(int dbY);
@@ -65,6 +159,9 @@ class Painter
     int getX(float dbX);
     int getY(float dbY);
 
+    double toScreenX(double dbX);                           // Sub-pixel screen coordinates
+    double toScreenY(double dbY);                           // (used by the coverage buffer)
+
     void drawLine(CImgObj *img, int x1, int y1, int x2, int y2);
     void drawLine(CImgObj *img, int x1, int y1, int x2, int y2, Color c);
     void drawRect(CImgObj *img, int lx, int ly, int ux, int uy, Color rect_c, int w);
@@ -74,11 +171,54 @@ class Painter
                   // w : Thicnkness of border-line
 
     // Draw Cell
-    void drawCell     (CImgObj *img, const dbCell* cell);
-    void drawFixed    (CImgObj *img, const dbCell* cell);
-    void drawMovable  (CImgObj *img, const dbCell* cell);
-    void drawCells    (CImgObj *img);
+    // shiftY : y of the canvas row where img starts (for band images)
+    void drawCell     (CImgObj *img, const dbCell* cell, int shiftY = 0);
+    void drawFixed    (CImgObj *img, const dbCell* cell, int shiftY = 0);
+    void drawMovable  (CImgObj *img, const dbCell* cell, int shiftY = 0);
+    void drawCells    (CImgObj *img);                       // uses db_->numThreads()
+    void drawCells    (CImgObj *img, int numThreads,
+                       const dbPlacement* placement = nullptr); // Positions of db_->cells() if nullptr
     void drawDie      (CImgObj *img);
+    void drawScene    (CImgObj *img);                       // Die + (cells or heatmap_)
+
+    // Heatmap
+    const BinGrid* heatmap_;                                // nullptr if cells are drawn
+    float          heatmapRange_;                           // Value drawn with the hottest color
+
+    void drawHeatmap  (CImgObj *img, const BinGrid& grid, float range);
+
+    // Level-of-Detail (Tile-based) Rendering
+    int numTileX_;
+    int numTileY_;
+
+    typedef std::vector<std::vector<float>> TileCoverage;   // Per-tile coverage buffer of one band
+                                                            // (allocated only for touched tiles)
+
+    // Box of a cell to be drawn (dbu)
+    // taken from the DB or from a placement snapshot
+    struct CellBox
+    {
+      int  lx;
+      int  ly;
+      int  ux;
+      int  uy;
+      bool isBlock;                                         // Fixed or Macro (never accumulated)
+    };
+
+    int  getTileID     (const CellBox& box);
+    void getBandRange  (const CellBox& box, int& lb, int& ub); // Bands (tile rows) touched by the cell
+    void splatCell     (TileCoverage& coverage, const CellBox& box, int bandLy, int bandUy);
+    void blendCoverage (CImgObj *band, const TileCoverage& coverage);
+    void drawBox       (CImgObj *img, const CellBox& box, int shiftY);
+
+    // Multi-threaded Rasterization
+    // The canvas is split into horizontal bands of LOD_TILE_SIZE rows.
+    // Each band is drawn into its own image by one thread.
+    void drawBand      (CImgObj *img, int bandID,
+                        const std::vector<CellBox>& boxes,
+                        const std::vector<char>& isSmall,   // cells to be accumulated
+                        const int* bandCellBegin,           // cells touching this band
+                        const int* bandCellEnd);            // (in the order of db_->cells())
 
     void show();
 
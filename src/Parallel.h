@@ -0,0 +1,121 @@
+#pragma once
+
+// Parallel loops of LefDefDB / Painter
+// Internal header of LefDefDB (not installed).
+// The calling thread is worker 0. If a job throws, the workers are joined
+// and the first exception is thrown again by the caller.
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <exception>
+
+namespace LefDefDB
+{
+
+// First exception of the workers
+class WorkerError
+{
+  public:
+
+    template<typename Func>
+    void run(Func func)
+    {
+      try
+      {
+        func();
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if(!error_)
+          error_ = std::current_exception();
+      }
+    }
+
+    void rethrow() const
+    {
+      if(error_)
+        std::rethrow_exception(error_);
+    }
+
+  private:
+
+    std::mutex         mutex_;
+    std::exception_ptr error_;
+};
+
+// Run job(threadID, begin, end) on numThreads threads
+// Each thread takes a contiguous chunk of [0, numItem)
+template<typename Job>
+void runChunks(int numThreads, int numItem, const Job& job)
+{
+  const int chunkSize = (numItem + numThreads - 1) / std::max(1, numThreads);
+
+  WorkerError error;
+
+  auto worker = [&] (int t)
+  {
+    error.run([&] ()
+    {
+      job(t, std::min(numItem, t * chunkSize), std::min(numItem, (t + 1) * chunkSize));
+    });
+  };
+
+  std::vector<std::thread> threads;
+
+  for(int t = 1; t < numThreads; t++)
+    threads.emplace_back(worker, t);
+
+  worker(0);
+
+  for(auto& thread : threads)
+    thread.join();
+
+  error.rethrow();
+}
+
+// Run job(chunk) for every chunk of [0, numChunk) on numThreads threads
+// The chunks are taken in order from a shared counter (for jobs of uneven cost).
+// After an exception, the other workers stop at their next chunk.
+template<typename Job>
+void runQueue(int numThreads, int numChunk, const Job& job)
+{
+  std::atomic<int> nextChunk(0);
+
+  WorkerError error;
+
+  auto worker = [&] ()
+  {
+    error.run([&] ()
+    {
+      try
+      {
+        for(int c = nextChunk++; c < numChunk; c = nextChunk++)
+          job(c);
+      }
+      catch(...)
+      {
+        nextChunk = numChunk;
+        throw;
+      }
+    });
+  };
+
+  std::vector<std::thread> threads;
+
+  for(int t = 1; t < numThreads; t++)
+    threads.emplace_back(worker);
+
+  worker();
+
+  for(auto& thread : threads)
+    thread.join();
+
+  error.rethrow();
+}
+
+} // namespace LefDefDB
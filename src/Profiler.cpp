@@ -0,0 +1,228 @@
+#include "Profiler.h"
+
+#include <mutex>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+#include <sys/resource.h>
+
+namespace LefDefDB
+{
+
+static std::mutex                           profileMutex;
+static std::vector<Profiler::Entry>         profileEntries;
+static std::unordered_map<std::string, int> profileEntryMap;    // Path - Index of profileEntries
+
+// Path of the innermost open scope of this thread
+static thread_local std::string scopePath;
+static thread_local int         scopeDepth = 0;
+
+long
+Profiler::peakRssKB()
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss; // KB on Linux
+}
+
+uint64_t
+Profiler::numAllocs()
+{
+  return allocCounter_.load(std::memory_order_relaxed);
+}
+
+int
+Profiler::openEntry(const std::string& path, int depth)
+{
+  std::lock_guard<std::mutex> lock(profileMutex);
+
+  auto [itr, isNew] = profileEntryMap.try_emplace(path, profileEntries.size());
+
+  if(isNew)
+  {
+    profileEntries.emplace_back();
+    profileEntries.back().path  = path;
+    profileEntries.back().depth = depth;
+  }
+
+  return itr->second;
+}
+
+void
+Profiler::closeEntry(int entryID, double wallTime, double cpuTime,
+                     long peakRssKB, uint64_t numAllocs)
+{
+  std::lock_guard<std::mutex> lock(profileMutex);
+
+  Entry& entry = profileEntries[entryID];
+
+  entry.calls++;
+  entry.wallTime  += wallTime;
+  entry.cpuTime   += cpuTime;
+  entry.peakRssKB += peakRssKB;
+  entry.numAllocs += numAllocs;
+}
+
+ProfileScope::ProfileScope(const std::string& name)
+  : isStopped_ (false)
+{
+  parentLen_ = scopePath.size();
+
+  if(!scopePath.empty())
+    scopePath.push_back('/');
+
+  scopePath.append(name);
+
+  entryID_ = Profiler::openEntry(scopePath, scopeDepth++);
+
+  // Taken last, so the bookkeeping above is not counted
+  peakRssStart_  = Profiler::peakRssKB();
+  cpuStart_      = std::clock();
+  numAllocStart_ = Profiler::numAllocs();
+  wallStart_     = std::chrono::steady_clock::now();
+}
+
+void
+ProfileScope::stop()
+{
+  if(isStopped_)
+    return;
+
+  auto         wallEnd     = std::chrono::steady_clock::now();
+  uint64_t     numAllocEnd = Profiler::numAllocs();
+  std::clock_t cpuEnd      = std::clock();
+  long         peakRssEnd  = Profiler::peakRssKB();
+
+  std::chrono::duration<double> wallTime = wallEnd - wallStart_;
+
+  Profiler::closeEntry(entryID_, wallTime.count(),
+                       double(cpuEnd - cpuStart_) / CLOCKS_PER_SEC,
+                       peakRssEnd - peakRssStart_,
+                       numAllocEnd - numAllocStart_);
+
+  scopePath.resize(parentLen_);
+  scopeDepth--;
+
+  isStopped_ = true;
+}
+
+bool
+Profiler::findEntry(const std::string& path, Entry& entry)
+{
+  std::lock_guard<std::mutex> lock(profileMutex);
+
+  auto itr = profileEntryMap.find(path);
+
+  if(itr == profileEntryMap.end() || profileEntries[itr->second].calls == 0)
+    return false;
+
+  entry = profileEntries[itr->second];
+  return true;
+}
+
+void
+Profiler::printTable(std::ostream& os)
+{
+  std::lock_guard<std::mutex> lock(profileMutex);
+
+  using namespace std;
+
+  // Stream state is restored at the end (os can be shared)
+  ios_base::fmtflags flags = os.flags();
+  streamsize precision     = os.precision();
+
+  const string line(92, '-');
+
+  os << endl;
+  os << "*** Profile ***" << endl;
+  os << line << endl;
+  os << " " << left  << setw(32) << "Phase"
+            << right << setw(7)  << "Calls"
+                     << setw(12) << "Wall (s)"
+                     << setw(12) << "CPU (s)"
+                     << setw(15) << "Peak RSS (MB)"
+                     << setw(13) << "Allocs" << endl;
+  os << line << endl;
+
+  for(const Entry& entry : profileEntries)
+  {
+    // Scopes still open (e.g. report_profile itself)
+    if(entry.calls == 0)
+      continue;
+
+    // Only the last part of the path (indented by depth)
+    string name = string(2 * entry.depth, ' ')
+                + entry.path.substr( entry.path.find_last_of('/') + 1 );
+
+    char rss[32];
+    snprintf(rss, sizeof(rss), "+%.2f", entry.peakRssKB / 1024.0);
+
+    os << " " << left  << setw(32) << name
+              << right << setw(7)  << entry.calls
+              << fixed << setprecision(4)
+                       << setw(12) << entry.wallTime
+                       << setw(12) << entry.cpuTime
+                       << setw(15) << rss
+                       << setw(13) << entry.numAllocs << endl;
+  }
+
+  os << line << endl;
+  os << " Peak RSS : " << fixed << setprecision(2) << peakRssKB() / 1024.0 << " MB" << endl;
+  os << line << endl;
+
+  os.flags(flags);
+  os.precision(precision);
+}
+
+bool
+Profiler::writeJson(const std::string& fileName)
+{
+  std::ofstream ofs(fileName);
+
+  if(!ofs.good())
+    return false;
+
+  std::lock_guard<std::mutex> lock(profileMutex);
+
+  auto escape = [] (const std::string& str)
+  {
+    std::string out;
+    for(char c : str)
+    {
+      if(c == '"' || c == '\\')
+        out.push_back('\\');
+      out.push_back(c);
+    }
+    return out;
+  };
+
+  ofs << "{\n";
+  ofs << "  \"peak_rss_kb\": " << peakRssKB() << ",\n";
+  ofs << "  \"phases\": [";
+
+  bool first = true;
+
+  for(const Entry& entry : profileEntries)
+  {
+    if(entry.calls == 0)
+      continue;
+
+    ofs << (first ? "\n" : ",\n");
+    ofs << "    {\"path\": \"" << escape(entry.path) << "\", "
+        << "\"depth\": "             << entry.depth     << ", "
+        << "\"calls\": "             << entry.calls     << ", "
+        << "\"wall_s\": "            << entry.wallTime  << ", "
+        << "\"cpu_s\": "             << entry.cpuTime   << ", "
+        << "\"peak_rss_delta_kb\": " << entry.peakRssKB << ", "
+        << "\"allocs\": "            << entry.numAllocs << "}";
+
+    first = false;
+  }
+
+  ofs << "\n  ]\n}\n";
+
+  return ofs.good();
+}
+
+} // namespace LefDefDB
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace LefDefDB
+{
+
+// Scoped timer
+// Records wall time, CPU time (all threads of the process),
+// growth of the peak RSS and the number of heap allocations (operator new)
+// between the constructor and the destructor (or stop()).
+// Scopes opened inside another scope are recorded as "outer/inner".
+class ProfileScope
+{
+  public:
+
+    ProfileScope(const std::string& name);
+    ~ProfileScope() { stop(); }
+
+    // Ends the scope before the destructor (for sequential phases in one function)
+    // Scopes should be stopped in the reverse order of construction.
+    void stop();
+
+  private:
+
+    bool     isStopped_;
+    int      entryID_;
+    size_t   parentLen_;                                    // Length of the parent path
+
+    std::chrono::steady_clock::time_point wallStart_;
+    std::clock_t cpuStart_;
+    long         peakRssStart_;                             // KB
+    uint64_t     numAllocStart_;
+};
+
+// Accumulated result of ProfileScopes (same path is merged)
+class Profiler
+{
+  public:
+
+    struct Entry
+    {
+      std::string path;                                     // e.g. read_def/tokenize
+      int         depth;                                    // Number of parent scopes
+
+      int      calls       = 0;
+      double   wallTime    = 0.0;                           // s
+      double   cpuTime     = 0.0;                           // s
+      long     peakRssKB   = 0;                             // Growth of the peak RSS
+      uint64_t numAllocs   = 0;
+    };
+
+    static void printTable (std::ostream& os);              // In the order of the first call
+    static bool writeJson  (const std::string& fileName);   // false if the file cannot be written
+
+    static bool findEntry  (const std::string& path,        // false if the scope is never closed
+                            Entry& entry);
+
+    static long     peakRssKB();                            // Peak RSS of the process
+    static uint64_t numAllocs();                            // Number of operator new calls so far
+                                                            // (0 without AllocHook.cpp)
+
+    // Called by the operator new of AllocHook.cpp
+    // (relaxed atomic : the order of the counts does not matter)
+    static void countAlloc() { allocCounter_.fetch_add(1, std::memory_order_relaxed); }
+
+  private:
+
+    friend class ProfileScope;
+
+    inline static std::atomic<uint64_t> allocCounter_ {0};
+
+    static int  openEntry (const std::string& path, int depth);
+    static void closeEntry(int entryID, double wallTime, double cpuTime,
+                           long peakRssKB, uint64_t numAllocs);
+};
+
+} // namespace LefDefDB
@@ -0,0 +1,234 @@
+#include "RTree.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace LefDefDB
+{
+
+// Children per node
+static constexpr int nodeCapacity = 16;
+
+// Sort the items in STR order : slices of (numSlice x nodeCapacity) items by x,
+// then each slice by y (so every nodeCapacity items make a compact node)
+template<typename T>
+static void strSort(std::vector<T>& items, size_t begin, size_t end)
+{
+  const size_t numItem   = end - begin;
+  const size_t numNode   = (numItem + nodeCapacity - 1) / nodeCapacity;
+  const size_t numSlice  = static_cast<size_t>( std::ceil( std::sqrt( double(numNode) ) ) );
+  const size_t sliceSize = numSlice * nodeCapacity;
+
+  // Twice the center (no rounding)
+  auto cx = [] (const T& a) { return static_cast<int64_t>(a.lx) + a.ux; };
+  auto cy = [] (const T& a) { return static_cast<int64_t>(a.ly) + a.uy; };
+
+  std::sort(items.begin() + begin, items.begin() + end,
+            [&] (const T& a, const T& b) { return cx(a) < cx(b); });
+
+  for(size_t s = begin; s < end; s += sliceSize)
+  {
+    std::sort(items.begin() + s, items.begin() + std::min(end, s + sliceSize),
+              [&] (const T& a, const T& b) { return cy(a) < cy(b); });
+  }
+}
+
+// Children of each parent for the items [begin, end) in STR order
+static void pack(int begin, int end, std::vector<std::pair<int, int>>& groups)
+{
+  groups.clear();
+
+  for(int i = begin; i < end; i += nodeCapacity)
+    groups.emplace_back(i, std::min(end, i + nodeCapacity));
+}
+
+Status
+RTree::build()
+{
+  if(!db_->isDefLoaded())
+    return Status::error("Error - Please read DEF first!");
+
+  std::vector<Object> objects;
+
+  for(const dbCell* cell : db_->cells())
+  {
+    if(cell->isMacro() && cell->isFixed())
+      objects.push_back( Object{cell->lx(), cell->ly(), cell->ux(), cell->uy(), Kind::Macro, cell->id()} );
+  }
+
+  for(const dbIO* io : db_->ios())
+    objects.push_back( Object{io->lx(), io->ly(), io->ux(), io->uy(), Kind::IO, io->id()} );
+
+  build(std::move(objects));
+
+  return Status();
+}
+
+void
+RTree::build(std::vector<Object> objects)
+{
+  objects_ = std::move(objects);
+  nodes_.clear();
+  numLeaf_ = 0;
+
+  if(objects_.empty())
+    return;
+
+  std::vector<std::pair<int, int>> groups;
+
+  // Leaves
+  strSort(objects_, 0, objects_.size());
+  pack(0, objects_.size(), groups);
+
+  auto addNode = [&] (auto& children, int begin, int end)
+  {
+    Node node{children[begin].lx, children[begin].ly, children[begin].ux, children[begin].uy, begin, end};
+
+    for(int i = begin + 1; i < end; i++)
+    {
+      node.lx = std::min(node.lx, children[i].lx);
+      node.ly = std::min(node.ly, children[i].ly);
+      node.ux = std::max(node.ux, children[i].ux);
+      node.uy = std::max(node.uy, children[i].uy);
+    }
+
+    nodes_.push_back(node);
+  };
+
+  nodes_.reserve(2 * groups.size() + 1);
+
+  for(auto [begin, end] : groups)
+    addNode(objects_, begin, end);
+
+  numLeaf_ = nodes_.size();
+
+  // Upper levels (a node moves with its range of children when the level is sorted)
+  int levelBegin = 0;
+  int levelEnd   = nodes_.size();
+
+  while(levelEnd - levelBegin > 1)
+  {
+    strSort(nodes_, levelBegin, levelEnd);
+    pack(levelBegin, levelEnd, groups);
+
+    for(auto [begin, end] : groups)
+      addNode(nodes_, begin, end);
+
+    levelBegin = levelEnd;
+    levelEnd   = nodes_.size();
+  }
+}
+
+template<typename Visit, typename Func>
+void
+RTree::search(Visit isVisited, Func func) const
+{
+  if(nodes_.empty())
+    return;
+
+  // Depth is log16(n) (a small stack is enough)
+  int stack[256];
+  int top = 0;
+
+  stack[top++] = nodes_.size() - 1;
+
+  while(top > 0)
+  {
+    const Node& node = nodes_[stack[--top]];
+
+    if(!isVisited(node))
+      continue;
+
+    if(&node - nodes_.data() < numLeaf_)
+    {
+      for(int i = node.begin; i < node.end; i++)
+        func(i);
+    }
+    else
+    {
+      for(int i = node.begin; i < node.end; i++)
+        stack[top++] = i;
+    }
+  }
+}
+
+void
+RTree::overlapping(int lx, int ly, int ux, int uy, std::vector<int>& objIDs) const
+{
+  auto isOverlapped = [&] (const auto& b)
+  {
+    return b.lx < ux && b.ux > lx && b.ly < uy && b.uy > ly;
+  };
+
+  search(isOverlapped, [&] (int i)
+  {
+    if(isOverlapped(objects_[i]))
+      objIDs.push_back(i);
+  });
+}
+
+void
+RTree::containedIn(int lx, int ly, int ux, int uy, std::vector<int>& objIDs) const
+{
+  // A node with an object inside the box touches the box
+  auto isTouched = [&] (const Node& b)
+  {
+    return b.lx <= ux && b.ux >= lx && b.ly <= uy && b.uy >= ly;
+  };
+
+  search(isTouched, [&] (int i)
+  {
+    const Object& o = objects_[i];
+
+    if(o.lx >= lx && o.ux <= ux && o.ly >= ly && o.uy <= uy)
+      objIDs.push_back(i);
+  });
+}
+
+void
+RTree::containing(int lx, int ly, int ux, int uy, std::vector<int>& objIDs) const
+{
+  // A node with an object containing the box contains the box
+  auto isContaining = [&] (const auto& b)
+  {
+    return b.lx <= lx && b.ux >= ux && b.ly <= ly && b.uy >= uy;
+  };
+
+  search(isContaining, [&] (int i)
+  {
+    if(isContaining(objects_[i]))
+      objIDs.push_back(i);
+  });
+}
+
+void
+RTree::freeSegments(int lx, int ly, int ux, int uy, std::vector<std::pair<int, int>>& segments) const
+{
+  segments.clear();
+
+  thread_local std::vector<int> objIDs;
+  objIDs.clear();
+
+  overlapping(lx, ly, ux, uy, objIDs);
+
+  // Blocked intervals from left to right
+  std::sort(objIDs.begin(), objIDs.end(),
+            [&] (int a, int b) { return objects_[a].lx < objects_[b].lx; });
+
+  int x = lx;
+
+  for(int i : objIDs)
+  {
+    const Object& o = objects_[i];
+
+    if(o.lx > x)
+      segments.emplace_back(x, o.lx);
+
+    x = std::max(x, o.ux);
+  }
+
+  if(x < ux)
+    segments.emplace_back(x, ux);
+}
+
+} // namespace LefDefDB
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include "LefDefParser.h"
+
+namespace LefDefDB
+{
+
+// Static R-tree over the big fixed objects of the die (fixed macros, IO pins)
+// Bulk loaded by Sort-Tile-Recursive (STR) packing : the boxes are sorted into
+// vertical slices by x, each slice by y, and packed into full nodes level by level.
+// So the nodes are stored in flat arrays and the children of a node are contiguous.
+// (DEF BLOCKAGES are not read by the parser yet, so they are not in the tree.)
+class RTree
+{
+  public:
+
+    enum class Kind { Macro, IO };
+
+    struct Object
+    {
+      int  lx, ly, ux, uy;
+      Kind kind;
+      int  id;                                              // cellID (Macro) / ioID (IO)
+    };
+
+    RTree(std::shared_ptr<LefDefParser> db) : db_ (db) {}
+
+    Status build();                                         // Fixed macros + IO pins of the DB
+    void   build(std::vector<Object> objects);              // Any boxes (e.g. benchmark)
+
+    // Queries (indices of objects() are appended in no particular order)
+    void overlapping(int lx, int ly, int ux, int uy,        // Overlapping the box (touching is not counted)
+                     std::vector<int>& objIDs) const;
+    void containedIn(int lx, int ly, int ux, int uy,        // Inside the box (boundary included)
+                     std::vector<int>& objIDs) const;
+    void containing (int lx, int ly, int ux, int uy,        // Containing the box (a point if lx == ux, ly == uy)
+                     std::vector<int>& objIDs) const;
+
+    // Row fragmentation : x intervals of [lx, ux) that are not covered
+    // by the objects overlapping the strip [lx, ux) x [ly, uy)
+    void freeSegments(int lx, int ly, int ux, int uy,
+                      std::vector<std::pair<int, int>>& segments) const;
+
+    // Getters
+    const std::vector<Object>& objects() const { return objects_; } // In STR order
+    int numNode() const { return nodes_.size(); }
+
+  private:
+
+    std::shared_ptr<LefDefParser> db_;
+
+    // Children are nodes_[begin, end) (objects_[begin, end) for the leaves)
+    struct Node
+    {
+      int lx, ly, ux, uy;
+      int begin, end;
+    };
+
+    std::vector<Object> objects_;
+    std::vector<Node>   nodes_;                             // Level by level from the leaves (root is the last)
+    int numLeaf_ = 0;                                       // nodes_[0, numLeaf_) are leaves
+
+    // Visit the objects of the subtrees that pass isVisited(box)
+    template<typename Visit, typename Func>
+    void search(Visit isVisited, Func func) const;
+};
+
+} // namespace LefDefDB
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <stdexcept>
+
+namespace LefDefDB
+{
+
+// Result of an API that can fail
+// Status() is a success. On failure, message() tells what went wrong
+// and the DB is left as it was before the call.
+class [[nodiscard]] Status
+{
+  public:
+
+    Status() : isOk_ (true) {}
+
+    static Status error(const std::string& message) { return Status(message); }
+
+    bool ok() const { return isOk_; }
+    explicit operator bool() const { return isOk_; }
+
+    const std::string& message() const { return message_; }
+
+  private:
+
+    Status(const std::string& message) : isOk_ (false), message_ (message) {}
+
+    bool        isOk_;
+    std::string message_;
+};
+
+// Thrown by the readers at the first error
+// (caught by the APIs of LefDefParser and returned as a Status)
+class ParseError : public std::runtime_error
+{
+  public:
+
+    ParseError(const std::string& message) : std::runtime_error(message) {}
+};
+
+} // namespace LefDefDB
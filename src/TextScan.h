@@ -0,0 +1,77 @@
+#pragma once
+
+// Scanners of the Verilog / DEF tokens (bit ranges)
+// Internal header of LefDefDB (not installed), shared with test/ScanTest.cpp.
+
+#include <string>
+#include <climits>
+
+namespace LefDefDB
+{
+
+// Check if the given string is contained in the squared bracket
+inline bool isSqrBracket(const std::string& str)
+{
+  return (!str.empty() && str[0] == '[' && str.back() == ']');
+}
+
+// Parse the bit range "msb:lsb" or "idx" in [begin, end)
+inline bool parseBitRange(const char* begin, const char* end, int& msb, int& lsb)
+{
+  auto readInt = [&] (int& value)
+  {
+    if(begin == end || *begin < '0' || *begin > '9')
+      return false;
+    value = 0;
+    while(begin != end && *begin >= '0' && *begin <= '9')
+    {
+      int digit = *begin++ - '0';
+      if(value > (INT_MAX - digit) / 10)
+        return false;
+      value = value * 10 + digit;
+    }
+    return true;
+  };
+
+  if( !readInt(msb) )
+    return false;
+
+  if(begin == end)
+  {
+    lsb = msb;
+    return true;
+  }
+
+  if(*begin++ != ':' || !readInt(lsb))
+    return false;
+
+  return (begin == end);
+}
+
+// Parse "[msb:lsb]" or "[idx]"
+inline bool parseBracketRange(const std::string& str, int& msb, int& lsb)
+{
+  return str.size() >= 2 && isSqrBracket(str)
+      && parseBitRange(str.data() + 1, str.data() + str.size() - 1, msb, lsb);
+}
+
+// Split "name[3]" or "name[3:0]" into the name and the bit range
+// Returns false if there is no bit selection
+inline bool splitBitSelect(const std::string& item, std::string& baseName, int& msb, int& lsb)
+{
+  if(item.empty() || item[0] == '\\' || item.back() != ']')
+    return false;
+
+  size_t left = item.rfind('[');
+
+  if(left == std::string::npos || left == 0)
+    return false;
+
+  if( !parseBitRange(item.data() + left + 1, item.data() + item.size() - 1, msb, lsb) )
+    return false;
+
+  baseName.assign(item, 0, left);
+  return true;
+}
+
+} // namespace LefDefDB
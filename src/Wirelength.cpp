@@ -0,0 +1,339 @@
+#include "Wirelength.h"
+#include "Parallel.h"
+
+#include <climits>
+#include <algorithm>
+
+namespace LefDefDB
+{
+
+// Nets per chunk (the unit of the parallel loop and of the summation)
+static constexpr int hpwlChunkSize = 4096;
+
+void
+Wirelength::setNetWeight(int netID, double weight)
+{
+  if(weights_.empty())
+    weights_.assign(db_->nets().size(), 1.0);
+
+  weights_[netID] = weight;
+}
+
+void
+Wirelength::excludeNet(int netID)
+{
+  if(isExcluded_.empty())
+    isExcluded_.assign(db_->nets().size(), false);
+
+  isExcluded_[netID] = true;
+}
+
+bool
+Wirelength::isCounted(int netID) const
+{
+  const dbNet* net = db_->nets()[netID];
+
+  if(net->isTie() || net->pins().size() < 2)
+    return false;
+
+  if(maxFanout_ > 0 && static_cast<int>(net->pins().size()) > maxFanout_)
+    return false;
+
+  return isExcluded_.empty() || !isExcluded_[netID];
+}
+
+Status
+Wirelength::computeHpwl()
+{
+  if(!db_->isDefLoaded())
+    return Status::error("Error - Please read DEF first!");
+
+  const std::vector<dbNet*>& nets = db_->nets();
+
+  const int numNet = nets.size();
+
+  // Step #1: CSR offsets (pins of the nets without wirelength are not gathered)
+  netStart_.assign(numNet + 1, 0);
+
+  numCounted_  = 0;
+  numExcluded_ = 0;
+
+  for(int i = 0; i < numNet; i++)
+  {
+    int numPin = nets[i]->pins().size();
+
+    if(isCounted(i))
+      numCounted_++;
+    else
+    {
+      if(!nets[i]->isTie() && numPin >= 2)
+        numExcluded_++;
+      numPin = 0;
+    }
+
+    netStart_[i + 1] = netStart_[i] + numPin;
+  }
+
+  pinX_.resize(netStart_[numNet]);
+  pinY_.resize(netStart_[numNet]);
+  netHpwl_.assign(numNet, 0);
+  boxes_.assign(numNet, NetBox{0, 0, 0, 0, 0, 0, 0, 0});
+  numRescan_ = 0;
+
+  // Step #2: Gather the pin coordinates and take the bounding box of each net
+  const int numChunk   = (numNet + hpwlChunkSize - 1) / hpwlChunkSize;
+  const int numThreads = std::max(1, std::min(db_->numThreads(), numChunk));
+
+  std::vector<double> chunkSum(numChunk, 0.0);
+
+  runQueue(numThreads, numChunk, [&] (int c)
+  {
+    const int netBegin = c * hpwlChunkSize;
+    const int netEnd   = std::min(numNet, netBegin + hpwlChunkSize);
+
+    double sum = 0.0;
+
+    for(int i = netBegin; i < netEnd; i++)
+    {
+      const int begin = netStart_[i];
+      const int end   = netStart_[i + 1];
+
+      if(begin == end)
+        continue;
+
+      int* x = pinX_.data();
+      int* y = pinY_.data();
+
+      int p = begin;
+
+      for(const dbPin* pin : nets[i]->pins())
+      {
+        pinLocation(pin, x[p], y[p]);
+        p++;
+      }
+
+      // Plain loops over contiguous ints (vectorized by the compiler)
+      int lx = INT_MAX;
+      int ux = INT_MIN;
+      int ly = INT_MAX;
+      int uy = INT_MIN;
+
+      for(p = begin; p < end; p++)
+      {
+        lx = std::min(lx, x[p]);
+        ux = std::max(ux, x[p]);
+      }
+
+      for(p = begin; p < end; p++)
+      {
+        ly = std::min(ly, y[p]);
+        uy = std::max(uy, y[p]);
+      }
+
+      // Pins on each side (for the incremental mode)
+      int numLx = 0;
+      int numUx = 0;
+      int numLy = 0;
+      int numUy = 0;
+
+      for(p = begin; p < end; p++)
+      {
+        numLx += (x[p] == lx);
+        numUx += (x[p] == ux);
+        numLy += (y[p] == ly);
+        numUy += (y[p] == uy);
+      }
+
+      boxes_[i] = NetBox{lx, ux, ly, uy, numLx, numUx, numLy, numUy};
+
+      int64_t hpwl = boxes_[i].hpwl();
+
+      netHpwl_[i] = hpwl;
+      sum        += weights_.empty() ? double(hpwl) : weights_[i] * hpwl;
+    }
+
+    chunkSum[c] = sum;
+  });
+
+  // Step #3: Sum of the chunks in order
+  totalHpwl_ = 0.0;
+
+  for(double sum : chunkSum)
+    totalHpwl_ += sum;
+
+  return Status();
+}
+
+void
+Wirelength::movedPins(int cellID, int newX, int newY, std::vector<MovedPin>& moved) const
+{
+  const dbCell* cell = db_->cells()[cellID];
+
+  const int numNet = netHpwl_.size();
+
+  moved.clear();
+
+  for(const dbPin* pin : cell->pins())
+  {
+    int netID = pin->nid();
+
+    // Unconnected pin or net without wirelength
+    if(netID < 0 || netID >= numNet || netStart_[netID] == netStart_[netID + 1])
+      continue;
+
+    int oldX, oldY;
+    pinLocation(pin, oldX, oldY);
+
+    int ox, oy;
+    db_->pinOffset(pin, ox, oy);
+
+    moved.push_back( MovedPin{netID, oldX, oldY, newX + ox, newY + oy} );
+  }
+
+  // A few pins per cell
+  std::sort(moved.begin(), moved.end(),
+            [] (const MovedPin& a, const MovedPin& b) { return a.netID < b.netID; });
+}
+
+Wirelength::NetBox
+Wirelength::movedBox(int netID, int cellID, int newX, int newY,
+                     const MovedPin* begin, const MovedPin* end, bool& isRescan) const
+{
+  NetBox box = boxes_[netID];
+
+  // Remove the old positions, then add the new ones
+  for(const MovedPin* m = begin; m != end; ++m)
+  {
+    box.numLx -= (m->oldX == box.lx);
+    box.numUx -= (m->oldX == box.ux);
+    box.numLy -= (m->oldY == box.ly);
+    box.numUy -= (m->oldY == box.uy);
+  }
+
+  auto addLower = [] (int v, int& bound, int& count)
+  {
+    if(v < bound)       { bound = v; count = 1; }
+    else if(v == bound) { count++;              }
+  };
+
+  auto addUpper = [] (int v, int& bound, int& count)
+  {
+    if(v > bound)       { bound = v; count = 1; }
+    else if(v == bound) { count++;              }
+  };
+
+  for(const MovedPin* m = begin; m != end; ++m)
+  {
+    addLower(m->newX, box.lx, box.numLx);
+    addUpper(m->newX, box.ux, box.numUx);
+    addLower(m->newY, box.ly, box.numLy);
+    addUpper(m->newY, box.uy, box.numUy);
+  }
+
+  isRescan = box.numLx == 0 || box.numUx == 0 
+          || box.numLy == 0 || box.numUy == 0;
+
+  if(!isRescan)
+    return box;
+
+  // The last pin of a side moved inward : scan the pins of the net
+  const dbCell* cell = db_->cells()[cellID];
+
+  box = NetBox{INT_MAX, INT_MIN, INT_MAX, INT_MIN, 0, 0, 0, 0};
+
+  for(const dbPin* pin : db_->nets()[netID]->pins())
+  {
+    int x, y;
+
+    if(!pin->isExternal() && pin->cell() == cell)
+    {
+      db_->pinOffset(pin, x, y);
+      x += newX;
+      y += newY;
+    }
+    else
+      pinLocation(pin, x, y);
+
+    addLower(x, box.lx, box.numLx);
+    addUpper(x, box.ux, box.numUx);
+    addLower(y, box.ly, box.numLy);
+    addUpper(y, box.uy, box.numUy);
+  }
+
+  return box;
+}
+
+template<typename Func>
+void
+Wirelength::forEachMovedNet(int cellID, int newX, int newY, Func func) const
+{
+  // Reused by the calls of this thread (no allocation per move)
+  thread_local std::vector<MovedPin> moved;
+
+  movedPins(cellID, newX, newY, moved);
+
+  const size_t numMoved = moved.size();
+
+  for(size_t i = 0; i < numMoved; )
+  {
+    size_t j = i + 1;
+
+    while(j < numMoved && moved[j].netID == moved[i].netID)
+      j++;
+
+    bool isRescan;
+    NetBox box = movedBox(moved[i].netID, cellID, newX, newY,
+                          moved.data() + i, moved.data() + j, isRescan);
+
+    func(moved[i].netID, box, isRescan);
+
+    i = j;
+  }
+}
+
+double
+Wirelength::evaluateMove(int cellID, int newX, int newY) const
+{
+  if(boxes_.empty())
+    return 0.0;
+
+  double delta = 0.0;
+
+  forEachMovedNet(cellID, newX, newY, [&] (int netID, const NetBox& box, bool isRescan)
+  {
+    double diff = static_cast<double>( box.hpwl() - boxes_[netID].hpwl() );
+    delta += weights_.empty() ? diff : weights_[netID] * diff;
+  });
+
+  return delta;
+}
+
+double
+Wirelength::commitMove(int cellID, int newX, int newY)
+{
+  if(boxes_.empty())
+    return 0.0;
+
+  double delta = 0.0;
+
+  // Boxes of the other nets do not depend on this net,
+  // so each one is written as soon as it is computed
+  forEachMovedNet(cellID, newX, newY, [&] (int netID, const NetBox& box, bool isRescan)
+  {
+    double diff = static_cast<double>( box.hpwl() - boxes_[netID].hpwl() );
+    delta += weights_.empty() ? diff : weights_[netID] * diff;
+
+    boxes_[netID]   = box;
+    netHpwl_[netID] = box.hpwl();
+
+    numRescan_ += isRescan;
+  });
+
+  db_->moveCell(cellID, newX, newY);
+
+  totalHpwl_ += delta;
+
+  return delta;
+}
+
+} // namespace LefDefDB
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "LefDefParser.h"
+
+namespace LefDefDB
+{
+
+// Half-perimeter wirelength (HPWL) of the nets
+// Pin coordinates are gathered net by net into flat arrays (CSR),
+// so the bounding box of a net is a min / max over contiguous ints.
+// Tie nets and nets with less than 2 pins have no wirelength.
+// The total is summed in fixed chunks of nets (same result for any number of threads).
+//
+// Incremental mode (after computeHpwl)
+// The bounding box of each net and the number of pins on each of its sides are cached.
+// A pin moving outward or along a side updates the box in O(1),
+// and the pins of the net are scanned again only if the last pin of a side moves inward.
+class Wirelength
+{
+  public:
+
+    Wirelength(std::shared_ptr<LefDefParser> db) : db_ (db) {}
+
+    // Options (before computeHpwl)
+    void setMaxFanout(int maxFanout) { maxFanout_ = maxFanout; } // Nets with more pins are excluded (0 : no limit)
+    void setNetWeight(int netID, double weight);            // 1.0 by default
+    void excludeNet  (int netID);
+
+    Status computeHpwl();                                   // Every net of the DB
+
+    // HPWL change (weighted, dbu) if the lower-left of the cell moves to (newX, newY)
+    // (neither the DB nor the cache is changed)
+    double evaluateMove(int cellID, int newX, int newY) const;
+
+    // Move the cell in the DB and update the cache / total (returns the change)
+    double commitMove  (int cellID, int newX, int newY);
+
+    // Getters
+    double   totalHpwl() const { return totalHpwl_;   }     // Weighted sum (dbu)
+    int64_t    netHpwl(int netID) const { return netHpwl_[netID]; } // Not weighted (dbu, 0 if excluded)
+
+    int  numNetCounted() const { return numCounted_;  }     // Nets with wirelength
+    int numNetExcluded() const { return numExcluded_; }     // By max fanout / exclude list
+    int64_t numRescan()  const { return numRescan_;   }     // Nets scanned again by commitMove
+
+    const std::vector<int64_t>& netHpwls() const { return netHpwl_; }
+
+  private:
+
+    std::shared_ptr<LefDefParser> db_;
+
+    int maxFanout_   = 0;
+
+    std::vector<double> weights_;                           // Empty if every weight is 1.0
+    std::vector<char>   isExcluded_;                        // Empty if no net is excluded
+
+    // Pins of net i are [netStart_[i], netStart_[i + 1])
+    std::vector<int>    netStart_;
+    std::vector<int>    pinX_;
+    std::vector<int>    pinY_;
+
+    std::vector<int64_t> netHpwl_;
+
+    // Bounding box of a net and the number of pins on each side
+    struct NetBox
+    {
+      int lx, ux, ly, uy;
+      int numLx, numUx, numLy, numUy;
+
+      int64_t hpwl() const { return static_cast<int64_t>(ux) - lx
+                                  + static_cast<int64_t>(uy) - ly; }
+    };
+
+    std::vector<NetBox> boxes_;
+
+    // A pin of the moving cell
+    struct MovedPin
+    {
+      int netID;
+      int oldX, oldY;
+      int newX, newY;
+    };
+
+    double totalHpwl_  = 0.0;
+    int    numCounted_  = 0;
+    int    numExcluded_ = 0;
+    int64_t numRescan_  = 0;
+
+    bool isCounted(int netID) const;                        // false if the net has no wirelength
+
+    // Pins of the cell on the nets with wirelength (sorted by net)
+    void movedPins(int cellID, int newX, int newY, std::vector<MovedPin>& moved) const;
+
+    // Box of the net after the moves of [begin, end) (all on this net)
+    NetBox movedBox(int netID, int cellID, int newX, int newY,
+                    const MovedPin* begin, const MovedPin* end, bool& isRescan) const;
+
+    // Visit every move of the cell net by net : func(netID, new box)
+    template<typename Func>
+    void forEachMovedNet(int cellID, int newX, int newY, Func func) const;
+};
+
+} // namespace LefDefDB
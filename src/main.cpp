@@ -12,32 +12,80 @@
 
 #include "LefDefParser.h"
 #include "CmdInterpreter.h"
-#include "Painter.h"
+#include "CmdServer.h"
 
 using namespace LefDefDB;
-using namespace Graphic;
+
+// Prints the error of a failed Status
+inline bool check(const Status& status)
+{
+  if(!status)
+    std::cout << status.message() << std::endl;
+  return status.ok();
+}
 
 int main(int argc, char** argv)
 {
-  if(argc < 2)
+  // Parser <cmd file>
+  // Parser <cmd file> --batch <cmd file> ...  -> Run each script after the first one
+  //                                              (DEF is unloaded after each script)
+  // Parser --shell [<cmd file>]               -> Interactive shell
+  // Parser --serve <socket> [<cmd file>]      -> Keep the DB loaded (by the cmd file)
+  //                                              and run the commands from the socket
+  std::vector<std::string> args(argv + 1, argv + argc);
+
+  bool isShell  = !args.empty() && args[0] == "--shell";
+  bool isServer = !args.empty() && args[0] == "--serve";
+  bool isBatch  = args.size() > 1 && args[1] == "--batch";
+
+  if(args.empty() || (isServer && args.size() < 2) || (isBatch && args.size() < 3))
   {
     std::cout << "Please give input cmd file" << std::endl;
+    std::cout << "(or <cmd file> --batch <cmd file> ..., --shell [cmd file], --serve <socket> [cmd file])" << std::endl;
     exit(0);
   }
 
-  std::filesystem::path cmdfile = argv[1];
-
   std::shared_ptr<LefDefParser> parser;
   parser = std::make_shared<LefDefParser>();
 
+  CmdInterpreter cmd;
+  cmd.setParser(parser);
+
+#ifdef PARSER_WITH_PAINTER
   std::shared_ptr<Painter> painter;
   painter = std::make_shared<Painter>(parser);
 
-  CmdInterpreter cmd;
-  cmd.setParser(parser);
   cmd.setPainter(painter);
+#endif
+
+  if(isShell)
+  {
+    if(args.size() > 1 && !check( cmd.readCmd(args[1]) ))
+      return 1;
+
+    return check( cmd.runShell(std::cin) ) ? 0 : 1;
+  }
+
+  if(!isServer)
+  {
+    if(!check( cmd.readCmd(args[0]) ))
+      return 1;
+
+    if(!isBatch)
+      return 0;
+
+    std::vector<std::filesystem::path> batch(args.begin() + 2, args.end());
+
+    return check( cmd.readBatch(batch) ) ? 0 : 1;
+  }
+
+  if(args.size() > 2 && !check( cmd.readCmd(args[2]) ))
+    return 1;
 
-  cmd.readCmd(cmdfile);
+  CmdServer server(parser);
+#ifdef PARSER_WITH_PAINTER
+  server.setPainter(painter);
+#endif
 
-  return 0;
+  return check( server.serve(args[1]) ) ? 0 : 1;
 }
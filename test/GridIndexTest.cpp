@@ -0,0 +1,252 @@
+// Parser_grid_index_test (ctest : grid_index)
+//
+// Checks GridIndex (src/GridIndex.h) under moveCell against brute force.
+//   - 30k random moves, with cellsInBox / pinsInBox / nearestCell / nearestPin
+//     compared to a scan of every cell and pin
+//   - 1500 cells moved into one bin : the free slots run out (overflow list),
+//     and the grid is rebuilt when the list passes 1024 items
+// The exit code is the number of failures.
+
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+#include "TestDesign.h"
+#include "GridIndex.h"
+
+using namespace LefDefDB;
+
+static int numFail = 0;
+
+static void check(bool isPass, const char* what, int64_t index)
+{
+  if(!isPass)
+  {
+    // Only the first failures are printed
+    if(numFail < 20)
+      printf("FAIL %-20s (%lld)\n", what, static_cast<long long>(index));
+    numFail++;
+  }
+}
+
+static int64_t distance2(int x, int y, int lx, int ly, int ux, int uy)
+{
+  int64_t dx = x < lx ? lx - x : (x > ux ? x - ux : 0);
+  int64_t dy = y < ly ? ly - y : (y > uy ? y - uy : 0);
+  return dx * dx + dy * dy;
+}
+
+class GridChecker
+{
+  public:
+
+    GridChecker(std::shared_ptr<LefDefParser> db, const GridIndex& grid)
+      : db_ (db), grid_ (grid), rng_ (1) {}
+
+    // Queries around random points (and around (x, y) if it is given)
+    void checkQueries(int64_t numMove, int numQuery, int x = INT_MIN, int y = INT_MIN);
+
+    std::mt19937& rng() { return rng_; }
+
+  private:
+
+    std::shared_ptr<LefDefParser> db_;
+    const GridIndex& grid_;
+    std::mt19937 rng_;
+
+    int randomIn(int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng_); }
+
+    void checkBox    (int64_t numMove, int lx, int ly, int ux, int uy);
+    void checkNearest(int64_t numMove, int x, int y);
+};
+
+void
+GridChecker::checkBox(int64_t numMove, int lx, int ly, int ux, int uy)
+{
+  std::vector<int> result;
+  std::vector<int> expected;
+
+  grid_.cellsInBox(lx, ly, ux, uy, result);
+
+  for(const dbCell* cell : db_->cells())
+  {
+    if(cell->lx() < ux && cell->ux() > lx && cell->ly() < uy && cell->uy() > ly)
+      expected.push_back(cell->id());
+  }
+
+  std::sort(result.begin(), result.end());
+  check(result == expected, "cellsInBox", numMove);
+
+  result.clear();
+  expected.clear();
+
+  grid_.pinsInBox(lx, ly, ux, uy, result);
+
+  for(const dbPin* pin : db_->pins())
+  {
+    int x, y;
+    pinLocation(pin, x, y);
+
+    if(x >= lx && x <= ux && y >= ly && y <= uy)
+      expected.push_back(pin->id());
+  }
+
+  std::sort(result.begin(), result.end());
+  check(result == expected, "pinsInBox", numMove);
+}
+
+void
+GridChecker::checkNearest(int64_t numMove, int x, int y)
+{
+  // Ties go to the smallest ID
+  int     bestCell = -1;
+  int64_t bestD    = INT64_MAX;
+
+  for(const dbCell* cell : db_->cells())
+  {
+    int64_t d = distance2(x, y, cell->lx(), cell->ly(), cell->ux(), cell->uy());
+
+    if(d < bestD)
+    {
+      bestCell = cell->id();
+      bestD    = d;
+    }
+  }
+
+  check(grid_.nearestCell(x, y) == bestCell, "nearestCell", numMove);
+
+  int bestPin = -1;
+  bestD = INT64_MAX;
+
+  for(const dbPin* pin : db_->pins())
+  {
+    int px, py;
+    pinLocation(pin, px, py);
+
+    int64_t d = distance2(x, y, px, py, px, py);
+
+    if(d < bestD)
+    {
+      bestPin = pin->id();
+      bestD   = d;
+    }
+  }
+
+  check(grid_.nearestPin(x, y) == bestPin, "nearestPin", numMove);
+}
+
+void
+GridChecker::checkQueries(int64_t numMove, int numQuery, int x, int y)
+{
+  const dbDie* die  = db_->die();
+  const int    span = 10 * grid_.binSize();
+
+  for(int q = 0; q < numQuery; q++)
+  {
+    const int cx = (x == INT_MIN) ? randomIn(die->lx(), die->ux()) : x;
+    const int cy = (y == INT_MIN) ? randomIn(die->ly(), die->uy()) : y;
+
+    const int lx = cx - randomIn(0, span);
+    const int ly = cy - randomIn(0, span);
+
+    checkBox(numMove, lx, ly, cx + randomIn(0, span), cy + randomIn(0, span));
+    checkNearest(numMove, cx, cy);
+  }
+}
+
+int main()
+{
+  auto db = loadTestDesign("grid_index_test", 2000);
+
+  if(db == nullptr)
+    return 1;
+
+  GridIndex grid(db);
+  check(static_cast<bool>( grid.build() ), "build", 0);
+
+  GridChecker checker(db, grid);
+  std::mt19937& rng = checker.rng();
+
+  const dbDie* die = db->die();
+  const int numCell = db->cells().size();
+
+  auto randomIn = [&] (int lo, int hi) { return std::uniform_int_distribution<int>(lo, hi)(rng); };
+
+  checker.checkQueries(0, 20);
+
+  // Step #1: Random moves
+  const int numMove     = 30000;
+  const int checkPeriod = 100;
+
+  for(int m = 1; m <= numMove; m++)
+  {
+    const int     cellID = randomIn(0, numCell - 1);
+    const dbCell* cell   = db->cells()[cellID];
+
+    if(m % 2 == 0)
+    {
+      // Anywhere in the die
+      grid.moveCell(cellID, randomIn(die->lx(), die->ux() - cell->dx()),
+                            randomIn(die->ly(), die->uy() - cell->dy()));
+    }
+    else
+    {
+      // Around the old bin
+      grid.moveCell(cellID, cell->lx() + randomIn(-2 * grid.binSize(), 2 * grid.binSize()),
+                            cell->ly() + randomIn(-2 * grid.binSize(), 2 * grid.binSize()));
+    }
+
+    if(m % checkPeriod == 0)
+      checker.checkQueries(m, 5);
+  }
+
+  // Step #2: Standard cells into the bin at the center of the die
+  const int hotX = die->lx() + (die->ux() - die->lx()) / 2;
+  const int hotY = die->ly() + (die->uy() - die->ly()) / 2;
+
+  std::vector<int> hotCells;
+
+  for(const dbCell* cell : db->cells())
+  {
+    if(cell->isStdCell() && hotCells.size() < 1500)
+      hotCells.push_back(cell->id());
+  }
+
+  check(hotCells.size() == 1500, "number of std cells", hotCells.size());
+
+  for(size_t i = 0; i < hotCells.size(); i++)
+  {
+    grid.moveCell(hotCells[i], hotX, hotY);
+
+    // In the overflow list (before the rebuild), then after the rebuild
+    if(i == 500 || i == 1020 || i == 1100 || i + 1 == hotCells.size())
+    {
+      checker.checkQueries(numMove + i, 5, hotX, hotY);
+      checker.checkQueries(numMove + i, 5);
+    }
+  }
+
+  // Step #3: Out of the full bin again
+  for(size_t i = 0; i < hotCells.size(); i++)
+  {
+    const dbCell* cell = db->cells()[hotCells[i]];
+
+    grid.moveCell(hotCells[i], randomIn(die->lx(), die->ux() - cell->dx()),
+                               randomIn(die->ly(), die->uy() - cell->dy()));
+
+    if(i % checkPeriod == 0)
+      checker.checkQueries(numMove + hotCells.size() + i, 5, hotX, hotY);
+  }
+
+  checker.checkQueries(numMove + 2 * hotCells.size(), 20);
+
+  printf("%d random moves, %zu moves into one bin (%d x %d bins)\n",
+         numMove, hotCells.size(), grid.numBinX(), grid.numBinY());
+
+  if(numFail == 0)
+    printf("All checks passed.\n");
+
+  return numFail;
+}
@@ -0,0 +1,143 @@
+// Parser_scan_test (ctest : scan)
+//
+// Checks the token scanners of the Verilog / DEF readers (src/TextScan.h)
+// on valid and malformed inputs. The exit code is the number of failures.
+
+#include <cstdio>
+#include <string>
+#include <climits>
+
+#include "TextScan.h"
+
+using namespace LefDefDB;
+
+static int numFail = 0;
+
+static void check(bool isPass, const char* what, const std::string& input)
+{
+  if(!isPass)
+  {
+    printf("FAIL %-20s \"%s\"\n", what, input.c_str());
+    numFail++;
+  }
+}
+
+// expected msb / lsb are ignored if isValid is false
+static void checkBitRange(const std::string& str, bool isValid, int msb = 0, int lsb = 0)
+{
+  int m = -1;
+  int l = -1;
+
+  bool result = parseBitRange(str.data(), str.data() + str.size(), m, l);
+
+  check(result == isValid, "parseBitRange", str);
+
+  if(result && isValid)
+    check(m == msb && l == lsb, "parseBitRange", str);
+}
+
+static void checkRange(const std::string& str, bool isValid, int msb = 0, int lsb = 0)
+{
+  int m = -1;
+  int l = -1;
+
+  bool result = parseBracketRange(str, m, l);
+
+  check(result == isValid, "parseBracketRange", str);
+
+  if(result && isValid)
+    check(m == msb && l == lsb, "parseBracketRange", str);
+}
+
+static void checkSelect(const std::string& item, bool isValid,
+                        const std::string& name = "", int msb = 0, int lsb = 0)
+{
+  std::string baseName;
+  int m = -1;
+  int l = -1;
+
+  bool result = splitBitSelect(item, baseName, m, l);
+
+  check(result == isValid, "splitBitSelect", item);
+
+  if(result && isValid)
+    check(baseName == name && m == msb && l == lsb, "splitBitSelect", item);
+}
+
+int main()
+{
+  // isSqrBracket
+  check( isSqrBracket("[0]"),     "isSqrBracket", "[0]");
+  check(!isSqrBracket(""),        "isSqrBracket", "");
+  check(!isSqrBracket("["),       "isSqrBracket", "[");
+  check(!isSqrBracket("a[0]b"),   "isSqrBracket", "a[0]b");
+
+  // parseBitRange (the text between the brackets)
+  checkBitRange("7:0",        true, 7, 0);
+  checkBitRange("0:7",        true, 0, 7);
+  checkBitRange("3",          true, 3, 3);
+  checkBitRange("0",          true, 0, 0);
+  checkBitRange("2147483647", true, INT_MAX, INT_MAX);
+  checkBitRange("2147483648", false);
+  checkBitRange("",           false);
+  checkBitRange(":",          false);
+  checkBitRange("7:",         false);
+  checkBitRange(":0",         false);
+  checkBitRange("7:0:1",      false);
+  checkBitRange("7-0",        false);
+  checkBitRange("-1",         false);
+  checkBitRange(" 7:0",       false);
+  checkBitRange("7:0 ",       false);
+  checkBitRange("[7:0]",      false);
+
+  // The end pointer bounds the scan (no terminator needed)
+  {
+    const std::string str = "12:3]";
+    int m = -1;
+    int l = -1;
+
+    bool result = parseBitRange(str.data(), str.data() + 4, m, l);
+    check(result && m == 12 && l == 3, "parseBitRange", "12:3 of 12:3]");
+
+    result = parseBitRange(str.data(), str.data() + 2, m, l);
+    check(result && m == 12 && l == 12, "parseBitRange", "12 of 12:3]");
+  }
+
+  // parseBracketRange
+  checkRange("[7:0]",  true, 7, 0);
+  checkRange("[0:7]",  true, 0, 7);
+  checkRange("[3]",    true, 3, 3);
+  checkRange("[31:16]", true, 31, 16);
+  checkRange("[a:0]",  false);
+  checkRange("[7:a]",  false);
+  checkRange("[]",     false);
+  checkRange("[7:",    false);
+  checkRange("[7:0",   false);
+  checkRange("7:0]",   false);
+  checkRange("[:0]",   false);
+  checkRange("[7:]",   false);
+  checkRange("[7:0:1]", false);
+  checkRange("[-1:0]", false);
+  checkRange("[ 7:0]", false);
+  checkRange("[99999999999:0]", false);
+  checkRange("",       false);
+  checkRange("[",      false);
+  checkRange("]",      false);
+
+  // splitBitSelect
+  checkSelect("bus[3]",       true, "bus", 3, 3);
+  checkSelect("bus[7:0]",     true, "bus", 7, 0);
+  checkSelect("a[1][2]",      true, "a[1]", 2, 2);
+  checkSelect("bus",          false);
+  checkSelect("[3]",          false);
+  checkSelect("bus[]",        false);
+  checkSelect("bus[x]",       false);
+  checkSelect("bus[3",        false);
+  checkSelect("\\esc[3]",     false);
+  checkSelect("",             false);
+
+  if(numFail == 0)
+    printf("All checks passed.\n");
+
+  return numFail;
+}
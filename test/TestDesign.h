@@ -0,0 +1,51 @@
+#pragma once
+
+// Small synthetic design for the checks of the incremental structures
+// (generated by bench/BenchGen in a temporary directory and read quietly)
+
+#include <memory>
+#include <string>
+#include <iostream>
+#include <filesystem>
+
+#include <unistd.h>
+
+#include "BenchGen.h"
+#include "LefDefParser.h"
+
+inline std::shared_ptr<LefDefDB::LefDefParser> loadTestDesign(const std::string& name, int64_t numInst)
+{
+  auto dir = std::filesystem::temp_directory_path()
+           / (name + "_" + std::to_string(getpid()));
+
+  BenchGen::Option genOpt;
+  genOpt.outDir  = dir.string();
+  genOpt.numInst = numInst;
+
+  BenchGen::Generator gen(genOpt);
+  gen.run();
+
+  auto db = std::make_shared<LefDefDB::LefDefParser>();
+
+  // The readers report to std::cout
+  std::streambuf* buf = std::cout.rdbuf(nullptr);
+
+  LefDefDB::Status status = db->readLef(gen.file(".lef"));
+
+  if(status)
+    status = db->readVerilog(gen.file(".v"));
+  if(status)
+    status = db->readDef(gen.file(".def"));
+
+  std::cout.rdbuf(buf);
+
+  std::filesystem::remove_all(dir);
+
+  if(!status)
+  {
+    std::cout << status.message() << std::endl;
+    return nullptr;
+  }
+
+  return db;
+}
@@ -0,0 +1,106 @@
+// Parser_wirelength_test (ctest : wirelength)
+//
+// Checks the incremental mode of Wirelength (src/Wirelength.h).
+// Random cells are moved by commitMove, and
+//   - evaluateMove before the move should return the same change as commitMove
+//   - the HPWL of every net and the total should match a fresh computeHpwl
+// Small moves are mixed in so that the pins on the box sides move inward (rescan path).
+// The exit code is the number of failures.
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "TestDesign.h"
+#include "Wirelength.h"
+
+using namespace LefDefDB;
+
+static int numFail = 0;
+
+static void check(bool isPass, const char* what, int64_t index)
+{
+  if(!isPass)
+  {
+    // Only the first failures are printed
+    if(numFail < 20)
+      printf("FAIL %-20s (%lld)\n", what, static_cast<long long>(index));
+    numFail++;
+  }
+}
+
+// Incremental state vs. a fresh computeHpwl of the DB
+static void checkRecompute(std::shared_ptr<LefDefParser> db, const Wirelength& incr, int64_t numMove)
+{
+  Wirelength fresh(db);
+  check(static_cast<bool>( fresh.computeHpwl() ), "computeHpwl", numMove);
+
+  const std::vector<int64_t>& incrHpwl  = incr.netHpwls();
+  const std::vector<int64_t>& freshHpwl = fresh.netHpwls();
+
+  check(incrHpwl.size() == freshHpwl.size(), "number of nets", numMove);
+
+  for(size_t i = 0; i < incrHpwl.size() && i < freshHpwl.size(); i++)
+    check(incrHpwl[i] == freshHpwl[i], "netHpwl", i);
+
+  // Integer HPWLs are exact in double
+  check(incr.totalHpwl() == fresh.totalHpwl(), "totalHpwl", numMove);
+}
+
+int main()
+{
+  auto db = loadTestDesign("wirelength_test", 2000);
+
+  if(db == nullptr)
+    return 1;
+
+  const int numMove     = 30000;
+  const int checkPeriod = 1000;
+
+  const dbDie* die = db->die();
+  const int numCell = db->cells().size();
+
+  Wirelength wl(db);
+  check(static_cast<bool>( wl.computeHpwl() ), "computeHpwl", 0);
+
+  std::mt19937 rng(1);
+
+  for(int m = 1; m <= numMove; m++)
+  {
+    const int     cellID = std::uniform_int_distribution<int>(0, numCell - 1)(rng);
+    const dbCell* cell   = db->cells()[cellID];
+
+    int newX, newY;
+
+    if(m % 2 == 0)
+    {
+      // Anywhere in the die
+      newX = std::uniform_int_distribution<int>(die->lx(), die->ux() - cell->dx())(rng);
+      newY = std::uniform_int_distribution<int>(die->ly(), die->uy() - cell->dy())(rng);
+    }
+    else
+    {
+      // A few sites away
+      newX = cell->lx() + std::uniform_int_distribution<int>(-2000, 2000)(rng);
+      newY = cell->ly() + std::uniform_int_distribution<int>(-4000, 4000)(rng);
+    }
+
+    double evaluated = wl.evaluateMove(cellID, newX, newY);
+    double committed = wl.commitMove  (cellID, newX, newY);
+
+    check(evaluated == committed, "evaluateMove", m);
+    check(cell->lx() == newX && cell->ly() == newY, "commitMove location", m);
+
+    if(m % checkPeriod == 0)
+      checkRecompute(db, wl, m);
+  }
+
+  check(wl.numRescan() > 0, "rescan path", wl.numRescan());
+
+  printf("%d moves, %lld nets scanned again\n", numMove, static_cast<long long>(wl.numRescan()));
+
+  if(numFail == 0)
+    printf("All checks passed.\n");
+
+  return numFail;
+}